@@ -54,12 +54,17 @@ typedef struct ArchMmu {
     LOS_DL_LIST         ptList;         /**< page table vm page list */
 } LosArchMmu;
 
+typedef VOID (*ArchMmuCopyHook)(VADDR_T vaddr, PADDR_T paddr, VOID *arg);
+
 BOOL OsArchMmuInit(LosArchMmu *archMmu, VADDR_T *virtTtb);
 STATUS_T LOS_ArchMmuQuery(const LosArchMmu *archMmu, VADDR_T vaddr, PADDR_T *paddr, UINT32 *flags);
 STATUS_T LOS_ArchMmuUnmap(LosArchMmu *archMmu, VADDR_T vaddr, size_t count);
 STATUS_T LOS_ArchMmuMap(LosArchMmu *archMmu, VADDR_T vaddr, PADDR_T paddr, size_t count, UINT32 flags);
 STATUS_T LOS_ArchMmuChangeProt(LosArchMmu *archMmu, VADDR_T vaddr, size_t count, UINT32 flags);
 STATUS_T LOS_ArchMmuMove(LosArchMmu *archMmu, VADDR_T oldVaddr, VADDR_T newVaddr, size_t count, UINT32 flags);
+STATUS_T LOS_ArchMmuCopyRange(LosArchMmu *srcMmu, LosArchMmu *dstMmu, VADDR_T vaddr, size_t count,
+                              ArchMmuCopyHook hook, VOID *arg);
+VOID LOS_ArchMmuInvalidateAsid(const LosArchMmu *archMmu);
 VOID LOS_ArchMmuContextSwitch(LosArchMmu *archMmu);
 STATUS_T LOS_ArchMmuDestroy(LosArchMmu *archMmu);
 VOID OsArchMmuInitPerCPU(VOID);
@@ -750,6 +750,148 @@ STATUS_T LOS_ArchMmuMove(LosArchMmu *archMmu, VADDR_T oldVaddr, VADDR_T newVaddr
     return LOS_OK;
 }
 
+STATIC INLINE PTE_T OsPte2WriteProtect(PTE_T pte2)
+{
+    /* only P_RW_U_NA and P_RW_U_RW are writable, setting AP2 turns them into the RO encoding */
+    if (((pte2 & MMU_DESCRIPTOR_L2_AP2_1) == 0) && ((pte2 & MMU_DESCRIPTOR_L2_AP01_3) != 0)) {
+        pte2 |= MMU_DESCRIPTOR_L2_AP2_1;
+    }
+    return pte2;
+}
+
+STATIC INLINE PTE_T OsPte1SectionWriteProtect(PTE_T pte1)
+{
+    if (((pte1 & MMU_DESCRIPTOR_L1_AP2_1) == 0) && ((pte1 & MMU_DESCRIPTOR_L1_AP01_3) != 0)) {
+        pte1 |= MMU_DESCRIPTOR_L1_AP2_1;
+    }
+    return pte1;
+}
+
+STATIC UINT32 OsCopySection(LosArchMmu *srcMmu, LosArchMmu *dstMmu, VADDR_T vaddr, UINT32 count,
+                            ArchMmuCopyHook hook, VOID *arg)
+{
+    PTE_T *srcPte1Ptr = OsGetPte1Ptr(srcMmu->virtTtb, vaddr);
+    PTE_T pte1 = OsPte1SectionWriteProtect(*srcPte1Ptr);
+    PADDR_T paddr = MMU_DESCRIPTOR_L1_SECTION_ADDR(pte1) + (vaddr & (MMU_DESCRIPTOR_L1_SMALL_SIZE - 1));
+    UINT32 index;
+
+    if (pte1 != *srcPte1Ptr) {
+        OsSavePte1(srcPte1Ptr, pte1);
+    }
+    OsSavePte1(OsGetPte1Ptr(dstMmu->virtTtb, vaddr), pte1);
+
+    for (index = 0; (index < count) && (hook != NULL); index++) {
+        hook(vaddr + (index << MMU_DESCRIPTOR_L2_SMALL_SHIFT), paddr + (index << MMU_DESCRIPTOR_L2_SMALL_SHIFT), arg);
+    }
+    return count;
+}
+
+STATIC STATUS_T OsCopyL2PTE(LosArchMmu *srcMmu, LosArchMmu *dstMmu, VADDR_T vaddr, UINT32 count,
+                            ArchMmuCopyHook hook, VOID *arg)
+{
+    PTE_T srcPte1 = OsGetPte1(srcMmu->virtTtb, vaddr);
+    PTE_T dstPte1 = OsGetPte1(dstMmu->virtTtb, vaddr);
+    PTE_T *srcPte2BasePtr = OsGetPte2BasePtr(srcPte1);
+    PTE_T *dstPte2BasePtr = NULL;
+    UINT32 pte2Index = OsGetPte2Index(vaddr);
+    UINT32 copied = 0;
+    PADDR_T pte2Base = 0;
+    PTE_T pte2;
+
+    if (srcPte2BasePtr == NULL) {
+        LOS_Panic("%s %d, pte2 base ptr is NULL\n", __FUNCTION__, __LINE__);
+    }
+
+    for (; count > 0; count--, pte2Index++, vaddr += MMU_DESCRIPTOR_L2_SMALL_SIZE) {
+        pte2 = srcPte2BasePtr[pte2Index];
+        if (OsIsPte2Invalid(pte2)) {
+            continue;
+        } else if (OsIsPte2LargePage(pte2)) {
+            LOS_Panic("%s %d, large page unimplemented\n", __FUNCTION__, __LINE__);
+        }
+
+        /* the child l2 table is only populated once there is something to put in it */
+        if (dstPte2BasePtr == NULL) {
+            if (OsIsPte1Invalid(dstPte1)) {
+                if (OsGetL2Table(dstMmu, OsGetPte1Index(vaddr), &pte2Base) != LOS_OK) {
+                    return LOS_ERRNO_VM_NO_MEMORY;
+                }
+                dstPte1 = pte2Base | MMU_DESCRIPTOR_L1_TYPE_PAGE_TABLE |
+                    (srcPte1 & MMU_DESCRIPTOR_L1_PAGETABLE_NON_SECURE);
+                dstPte1 &= MMU_DESCRIPTOR_L1_SMALL_DOMAIN_MASK;
+                dstPte1 |= MMU_DESCRIPTOR_L1_SMALL_DOMAIN_CLIENT;
+                OsSavePte1(OsGetPte1Ptr(dstMmu->virtTtb, vaddr), dstPte1);
+            } else if (!OsIsPte1PageTable(dstPte1)) {
+                LOS_Panic("%s %d, unimplemented tt_entry %x\n", __FUNCTION__, __LINE__, dstPte1);
+            }
+            dstPte2BasePtr = OsGetPte2BasePtr(dstPte1);
+            DMB;
+        }
+
+        pte2 = OsPte2WriteProtect(pte2);
+        srcPte2BasePtr[pte2Index] = pte2;
+        dstPte2BasePtr[pte2Index] = pte2;
+        if (hook != NULL) {
+            hook(vaddr, MMU_DESCRIPTOR_L2_SMALL_PAGE_ADDR(pte2), arg);
+        }
+        copied++;
+    }
+    DSB;
+
+    return copied;
+}
+
+/*
+ * Share every present page of [vaddr, vaddr + count pages) in srcMmu with dstMmu for fork: the
+ * l2 entries are copied table by table, write permission is dropped on both sides so that the
+ * first write takes a cow fault. The stale writable tlb entries of srcMmu are not invalidated
+ * here: the caller copies all of its ranges first and then calls LOS_ArchMmuInvalidateAsid once.
+ * The hook sees each shared page to take its references. Returns the number of pages shared or
+ * an error code.
+ */
+STATUS_T LOS_ArchMmuCopyRange(LosArchMmu *srcMmu, LosArchMmu *dstMmu, VADDR_T vaddr, size_t count,
+                              ArchMmuCopyHook hook, VOID *arg)
+{
+    PTE_T l1Entry;
+    UINT32 chunk;
+    STATUS_T ret;
+    INT32 copied = 0;
+
+    if ((srcMmu == NULL) || (dstMmu == NULL) || !MMU_DESCRIPTOR_IS_L2_SIZE_ALIGNED(vaddr)) {
+        return LOS_ERRNO_VM_INVALID_ARGS;
+    }
+
+    while (count > 0) {
+        chunk = MIN2((MMU_DESCRIPTOR_L1_SMALL_SIZE - (vaddr % MMU_DESCRIPTOR_L1_SMALL_SIZE)) >>
+            MMU_DESCRIPTOR_L2_SMALL_SHIFT, count);
+        l1Entry = OsGetPte1(srcMmu->virtTtb, vaddr);
+        if (OsIsPte1Section(l1Entry)) {
+            copied += OsCopySection(srcMmu, dstMmu, vaddr, chunk, hook, arg);
+        } else if (OsIsPte1PageTable(l1Entry)) {
+            ret = OsCopyL2PTE(srcMmu, dstMmu, vaddr, chunk, hook, arg);
+            if (ret < 0) {
+                copied = ret;
+                break;
+            }
+            copied += ret;
+        }
+        vaddr += chunk << MMU_DESCRIPTOR_L2_SMALL_SHIFT;
+        count -= chunk;
+    }
+
+    return copied;
+}
+
+VOID LOS_ArchMmuInvalidateAsid(const LosArchMmu *archMmu)
+{
+#ifdef LOSCFG_KERNEL_SMP
+    OsArmWriteTlbiasidis(archMmu->asid);
+#else
+    OsArmWriteTlbiasid(archMmu->asid);
+#endif
+    OsArmInvalidateTlbBarrier();
+}
+
 VOID LOS_ArchMmuContextSwitch(LosArchMmu *archMmu)
 {
     UINT32 ttbr;
@@ -2306,6 +2306,134 @@ ERROR_OUT:
     return -fatfs_2_vfs(result);
 }
 
+/* Read count sectors from sect into the page buffers starting at sector first of them, one disk read per
+ * stretch of buffers adjacent in memory */
+static FRESULT fatfs_read_to_pages(FATFS *fs, char **buffers, QWORD first, QWORD sect, QWORD count)
+{
+    QWORD spp = PAGE_SIZE / SS(fs); /* sectors per page */
+    QWORD page;
+    QWORD len;
+
+    while (count > 0) {
+        page = first / spp;
+        len = spp - (first % spp);
+        while ((len < count) && (buffers[page + 1] == buffers[page] + PAGE_SIZE)) {
+            page++;
+            len += spp;
+        }
+        len = (len < count) ? len : count;
+        if (disk_read(fs->pdrv, (BYTE *)buffers[first / spp] + (first % spp) * SS(fs), sect, len) != RES_OK) {
+            return FR_DISK_ERR;
+        }
+        first += len;
+        sect += len;
+        count -= len;
+    }
+    return FR_OK;
+}
+
+ssize_t fatfs_readpages(struct Vnode *vnode, char **buffers, size_t count, off_t pos)
+{
+    FATFS *fs = (FATFS *)(vnode->originMount->data);
+    DIR_FILE *dfp = (DIR_FILE *)(vnode->data);
+    FILINFO *finfo = &(dfp->fno);
+    FAT_ENTRY *ep = &(dfp->fat_entry);
+    DWORD clust;
+    DWORD next = 0;
+    QWORD sect;
+    QWORD left; /* sectors from sect to the end of the contiguous clusters found so far */
+    QWORD run;
+    QWORD total;
+    QWORD n;
+    size_t position; /* byte offset */
+    FRESULT result;
+    int ret;
+
+    ret = lock_fs(fs);
+    if (ret == FALSE) {
+        result = FR_TIMEOUT;
+        goto ERROR_OUT;
+    }
+
+    if (finfo->fsize <= pos) {
+        result = FR_OK;
+        goto ERROR_UNLOCK;
+    }
+
+    if (ep->clst == 0) {
+        ep->clst = finfo->sclst;
+    }
+
+    if (pos >= ep->pos) {
+        clust = ep->clst;
+        position = ep->pos;
+    } else {
+        clust = finfo->sclst;
+        position = 0;
+    }
+
+    /* Get to the current cluster */
+    n = pos / SS(fs) / fs->csize - position / SS(fs) / fs->csize;
+    while (n--) {
+        clust = get_fat(&(dfp->f_dir.obj), clust);
+        if ((clust == BAD_CLUSTER) || (clust == DISK_ERROR)) {
+            result = FR_DISK_ERR;
+            goto ERROR_UNLOCK;
+        }
+    }
+
+    total = min(finfo->fsize - pos, count * PAGE_SIZE);
+    total = (total + SS(fs) - 1) / SS(fs);
+    sect = clst2sect(fs, clust) + ((pos / SS(fs)) & (fs->csize - 1));
+    left = fs->csize - ((pos / SS(fs)) & (fs->csize - 1));
+
+    n = 0;
+    while (n < total) {
+        /* Merge the following clusters into one read as long as they are contiguous on the disk */
+        run = min(left, total - n);
+        while (((n + run) < total) && (run == left)) {
+            next = get_fat(&(dfp->f_dir.obj), clust);
+            if ((next == BAD_CLUSTER) || (next == DISK_ERROR)) {
+                result = FR_DISK_ERR;
+                goto ERROR_UNLOCK;
+            } else if (fatfs_is_last_cluster(fs, next)) {
+                total = n + run; /* read end */
+                break;
+            } else if (next != clust + 1) {
+                break;
+            }
+            clust = next;
+            left += fs->csize;
+            run = min(left, total - n);
+        }
+
+        result = fatfs_read_to_pages(fs, buffers, n, sect, run);
+        if (result != FR_OK) {
+            goto ERROR_UNLOCK;
+        }
+        n += run;
+        if (n >= total) {
+            break;
+        }
+        clust = next;
+        sect = clst2sect(fs, clust);
+        left = fs->csize;
+    }
+
+    /* Remember the cluster of the last sector read, the next sequential read starts from there */
+    ep->clst = clust;
+    ep->pos = (pos / SS(fs) + n - 1) * SS(fs);
+
+    unlock_fs(fs, FR_OK);
+
+    return (ssize_t)min(finfo->fsize - pos, n * SS(fs));
+
+ERROR_UNLOCK:
+    unlock_fs(fs, result);
+ERROR_OUT:
+    return -fatfs_2_vfs(result);
+}
+
 ssize_t fatfs_writepage(struct Vnode *vnode, char *buff, off_t pos, size_t buflen)
 {
     FATFS *fs = (FATFS *)(vnode->originMount->data);
@@ -2417,6 +2545,7 @@ struct VnodeOps fatfs_vops = {
     .Rename = fatfs_rename,
     .Create = fatfs_create,
     .ReadPage = fatfs_readpage,
+    .ReadPages = fatfs_readpages,
     .WritePage = fatfs_writepage,
     .Unlink = fatfs_unlink,
     .Reclaim = fatfs_reclaim,
@@ -63,6 +63,18 @@ extern void ProcMountsInit(void);
 
 extern void ProcUptimeInit(void);
 
+extern void ProcSchedLatencyInit(void);
+
+extern void ProcSchedBandwidthInit(void);
+
+extern void ProcSlabInfoInit(void);
+
+extern void ProcMemProfInit(void);
+
+extern void ProcZeroPoolInit(void);
+
+extern void ProcCompactInit(void);
+
 extern void ProcFsCacheInit(void);
 
 extern void ProcFdInit(void);
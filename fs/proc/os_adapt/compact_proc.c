@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sys/stat.h"
+#include "linux/errno.h"
+#include "proc_fs.h"
+#include "internal.h"
+#include "los_vm_phys.h"
+#include "securec.h"
+
+#ifdef LOSCFG_KERNEL_VM_COMPACTION
+static int CompactProcFill(struct SeqBuf *seqBuf, void *v)
+{
+    (void)v;
+
+    OsVmCompactShow(seqBuf);
+    return 0;
+}
+
+/* "<order>" compacts until a block of that order is free, "threshold <index>" tunes the background task */
+static ssize_t CompactProcWrite(struct ProcFile *pf, const char *buf, size_t count, loff_t *ppos)
+{
+    unsigned int value;
+
+    (void)pf;
+    (void)ppos;
+
+    if (buf == NULL) {
+        return -EINVAL;
+    }
+
+    if (sscanf_s(buf, "threshold %u", &value) == 1) {
+        return (OsVmCompactThresholdSet(value) == LOS_OK) ? (ssize_t)count : -EINVAL;
+    }
+
+    if (sscanf_s(buf, "%u", &value) != 1) {
+        return -EINVAL;
+    }
+
+    (void)OsVmCompact(value);
+    return (ssize_t)count;
+}
+
+static const struct ProcFileOperations COMPACT_PROC_FOPS = {
+    .read       = CompactProcFill,
+    .write      = CompactProcWrite,
+};
+
+void ProcCompactInit(void)
+{
+    struct ProcDirEntry *pde = CreateProcEntry("compaction", S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH, NULL);
+    if (pde == NULL) {
+        PRINT_ERR("creat /proc/compaction error!\n");
+        return;
+    }
+
+    pde->procFileOps = &COMPACT_PROC_FOPS;
+}
+#endif
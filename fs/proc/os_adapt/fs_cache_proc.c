@@ -102,17 +102,32 @@ static int PathCacheListProcess(struct SeqBuf *buf)
 static int PageCacheEntryProcess(struct SeqBuf *buf, struct page_mapping *mapping)
 {
     int total = 0;
-    LosFilePage *fpage = NULL;
+    unsigned int i;
+    unsigned int nr;
+    unsigned int intSave;
+    VM_OFFSET_T pgoffs[VM_FILE_PAGE_BATCH];
+    LosFilePage *fpages[VM_FILE_PAGE_BATCH];
+    VM_OFFSET_T next = 0;
 
     if (mapping->nrpages == 0) {
         LosBufPrintf(buf, "null]\n");
         return total;
     }
 
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        LosBufPrintf(buf, "%d,", fpage->pgoff);
-        total++;
-    }
+    do {
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        nr = OsFindGetEntries(mapping, next, fpages, VM_FILE_PAGE_BATCH);
+        for (i = 0; i < nr; i++) {
+            pgoffs[i] = fpages[i]->pgoff;
+        }
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+        for (i = 0; i < nr; i++) {
+            LosBufPrintf(buf, "%d,", pgoffs[i]);
+        }
+        total += nr;
+        next = (nr > 0) ? (pgoffs[nr - 1] + 1) : 0;
+    } while ((nr == VM_FILE_PAGE_BATCH) && (next != 0));
     LosBufPrintf(buf, "]\n");
     return total;
 }
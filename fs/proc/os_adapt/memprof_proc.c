@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sys/stat.h"
+#include "linux/errno.h"
+#include "proc_fs.h"
+#include "internal.h"
+#include "los_memprof_pri.h"
+#include "securec.h"
+
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+static int MemProfProcFill(struct SeqBuf *seqBuf, void *v)
+{
+    (void)v;
+
+    OsMemProfShow(seqBuf);
+    return 0;
+}
+
+/* "<interval>" sets the bytes allocated between two samples, 0 stops sampling */
+static ssize_t MemProfProcWrite(struct ProcFile *pf, const char *buf, size_t count, loff_t *ppos)
+{
+    unsigned int interval;
+
+    (void)pf;
+    (void)ppos;
+
+    if (buf == NULL) {
+        return -EINVAL;
+    }
+
+    if (sscanf_s(buf, "%u", &interval) != 1) {
+        return -EINVAL;
+    }
+
+    if (OsMemProfIntervalSet(interval) != LOS_OK) {
+        return -EINVAL;
+    }
+
+    return (ssize_t)count;
+}
+
+static const struct ProcFileOperations MEMPROF_PROC_FOPS = {
+    .read       = MemProfProcFill,
+    .write      = MemProfProcWrite,
+};
+
+void ProcMemProfInit(void)
+{
+    struct ProcDirEntry *pde = CreateProcEntry("memprof", S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH, NULL);
+    if (pde == NULL) {
+        PRINT_ERR("creat /proc/memprof error!\n");
+        return;
+    }
+
+    pde->procFileOps = &MEMPROF_PROC_FOPS;
+}
+#endif
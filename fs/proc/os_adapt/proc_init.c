@@ -63,6 +63,22 @@ void ProcFsInit(void)
 #endif
     ProcProcessInit();
     ProcUptimeInit();
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+    ProcSchedLatencyInit();
+#endif
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+    ProcSchedBandwidthInit();
+#endif
+    ProcSlabInfoInit();
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+    ProcMemProfInit();
+#endif
+#ifdef LOSCFG_KERNEL_VM_ZERO_POOL
+    ProcZeroPoolInit();
+#endif
+#ifdef LOSCFG_KERNEL_VM_COMPACTION
+    ProcCompactInit();
+#endif
     ProcFsCacheInit();
     ProcFdInit();
 #ifdef LOSCFG_KERNEL_PM
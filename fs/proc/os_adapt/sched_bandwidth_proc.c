@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sys/stat.h"
+#include "linux/errno.h"
+#include "proc_fs.h"
+#include "internal.h"
+#include "los_process_pri.h"
+#include "securec.h"
+
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+#define SCHED_BANDWIDTH_ARGC    3
+
+static int SchedBandwidthProcFill(struct SeqBuf *seqBuf, void *v)
+{
+    (void)v;
+
+    OsProcessGroupBandwidthShow(seqBuf);
+    return 0;
+}
+
+/* "<pgid> <quota_us> <period_us>", a quota of 0 removes the limit of the group */
+static ssize_t SchedBandwidthProcWrite(struct ProcFile *pf, const char *buf, size_t count, loff_t *ppos)
+{
+    unsigned int gid, quota;
+    unsigned int period = 0;
+    int ret;
+
+    (void)pf;
+    (void)ppos;
+
+    if (buf == NULL) {
+        return -EINVAL;
+    }
+
+    ret = sscanf_s(buf, "%u %u %u", &gid, &quota, &period);
+    if ((ret != SCHED_BANDWIDTH_ARGC) && !((ret == (SCHED_BANDWIDTH_ARGC - 1)) && (quota == 0))) {
+        return -EINVAL;
+    }
+
+    ret = OsSetProcessGroupBandwidth(gid, quota, period);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    return (ssize_t)count;
+}
+
+static const struct ProcFileOperations SCHED_BANDWIDTH_PROC_FOPS = {
+    .read       = SchedBandwidthProcFill,
+    .write      = SchedBandwidthProcWrite,
+};
+
+void ProcSchedBandwidthInit(void)
+{
+    struct ProcDirEntry *pde = CreateProcEntry("sched_bandwidth", S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH, NULL);
+    if (pde == NULL) {
+        PRINT_ERR("creat /proc/sched_bandwidth error!\n");
+        return;
+    }
+
+    pde->procFileOps = &SCHED_BANDWIDTH_PROC_FOPS;
+}
+#endif
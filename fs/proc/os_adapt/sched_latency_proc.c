@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sys/stat.h"
+#include "proc_fs.h"
+#include "internal.h"
+#include "los_sched_pri.h"
+
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+static int SchedLatencyProcFill(struct SeqBuf *seqBuf, void *v)
+{
+    (void)v;
+
+    OsSchedLatencyShow(seqBuf);
+    return 0;
+}
+
+/* Any write clears the histograms of all cpus */
+static ssize_t SchedLatencyProcWrite(struct ProcFile *pf, const char *buf, size_t count, loff_t *ppos)
+{
+    (void)pf;
+    (void)buf;
+    (void)ppos;
+
+    OsSchedLatencyReset();
+    return (ssize_t)count;
+}
+
+static const struct ProcFileOperations SCHED_LATENCY_PROC_FOPS = {
+    .read       = SchedLatencyProcFill,
+    .write      = SchedLatencyProcWrite,
+};
+
+void ProcSchedLatencyInit(void)
+{
+    struct ProcDirEntry *pde = CreateProcEntry("sched_latency", S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH, NULL);
+    if (pde == NULL) {
+        PRINT_ERR("creat /proc/sched_latency error!\n");
+        return;
+    }
+
+    pde->procFileOps = &SCHED_LATENCY_PROC_FOPS;
+}
+#endif
@@ -35,6 +35,7 @@
 #include "fs/fs_operation.h"
 #include "fs/file.h"
 #include "los_list.h"
+#include "los_vm_radix.h"
 
 typedef LOS_DL_LIST LIST_HEAD;
 typedef LOS_DL_LIST LIST_ENTRY;
@@ -127,6 +128,7 @@ struct Vnode {
     struct Mount *newMount;             /* fs info about who mount on this vnode */
     char *filePath;                     /* file path of the vnode */
     struct page_mapping mapping;        /* page mapping of the vnode */
+    VmRadixTree pageTree;               /* page cache pages of mapping, indexed by pgoff */
 };
 
 struct VnodeOps {
@@ -134,6 +136,7 @@ struct VnodeOps {
     int (*Lookup)(struct Vnode *parent, const char *name, int len, struct Vnode **vnode);
     int (*Open)(struct Vnode *vnode, int fd, int mode, int flags);
     ssize_t (*ReadPage)(struct Vnode *vnode, char *buffer, off_t pos);
+    ssize_t (*ReadPages)(struct Vnode *vnode, char **buffers, size_t count, off_t pos);
     ssize_t (*WritePage)(struct Vnode *vnode, char *buffer, off_t pos, size_t buflen);
     int (*Close)(struct Vnode *vnode);
     int (*Reclaim)(struct Vnode *vnode);
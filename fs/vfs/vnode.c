@@ -29,6 +29,7 @@
  */
 
 #include "los_mux.h"
+#include "los_slab_pri.h"
 #include "vnode.h"
 #include "fs/dirent_fs.h"
 #include "path_cache.h"
@@ -42,6 +43,7 @@ static int g_totalVnodeSize = 0;        /* total vnode size */
 static LosMux g_vnodeMux;
 static struct Vnode *g_rootVnode = NULL;
 static struct VnodeOps g_devfsOps;
+static SlabCache *g_vnodeCache = NULL;
 
 #define ENTRY_TO_VNODE(ptr)  LOS_DL_LIST_ENTRY(ptr, struct Vnode, actFreeEntry)
 #define VNODE_LRU_COUNT      10
@@ -58,6 +60,12 @@ int VnodesInit(void)
     LOS_ListInit(&g_vnodeFreeList);
     LOS_ListInit(&g_vnodeVirtualList);
     LOS_ListInit(&g_vnodeActiveList);
+    g_vnodeCache = OsSlabCacheCreate("vnode", sizeof(struct Vnode), NULL);
+    if (g_vnodeCache == NULL) {
+        PRINT_ERR("Create slab for vnode fail\n");
+        return -ENOMEM;
+    }
+
     retval = VnodeAlloc(NULL, &g_rootVnode);
     if (retval != LOS_OK) {
         PRINT_ERR("VnodeInit failed error %d\n", retval);
@@ -129,8 +137,11 @@ int VnodeAlloc(struct VnodeOps *vop, struct Vnode **newVnode)
     VnodeHold();
     vnode = GetFromFreeList();
     if ((vnode == NULL) && g_totalVnodeSize < LOSCFG_MAX_VNODE_SIZE) {
-        vnode = (struct Vnode*)zalloc(sizeof(struct Vnode));
-        g_totalVnodeSize++;
+        vnode = (struct Vnode*)OsSlabAlloc(g_vnodeCache);
+        if (vnode != NULL) {
+            (void)memset_s(vnode, sizeof(struct Vnode), 0, sizeof(struct Vnode));
+            g_totalVnodeSize++;
+        }
     }
 
     if (vnode == NULL) {
@@ -157,6 +168,7 @@ int VnodeAlloc(struct VnodeOps *vop, struct Vnode **newVnode)
         vnode->vop = vop;
     }
     LOS_ListInit(&vnode->mapping.page_list);
+    OsVmRadixTreeInit(&vnode->pageTree);
     LOS_SpinInit(&vnode->mapping.list_lock);
     (VOID)LOS_MuxInit(&vnode->mapping.mux_lock, NULL);
     vnode->mapping.host = vnode;
@@ -194,7 +206,7 @@ int VnodeFree(struct Vnode *vnode)
     if (vnode->vop == &g_devfsOps) {
         /* for dev vnode, just free it */
         free(vnode->data);
-        free(vnode);
+        OsSlabFree(g_vnodeCache, vnode);
         g_totalVnodeSize--;
     } else {
         /* for normal vnode, reclaim it to g_VnodeFreeList */
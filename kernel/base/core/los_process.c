@@ -54,6 +54,9 @@
 #include "los_vm_map.h"
 #include "los_vm_phys.h"
 #include "los_vm_syscall.h"
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+#include "los_seq_buf.h"
+#endif
 
 
 LITE_OS_SEC_BSS LosProcessCB *g_processCBArray = NULL;
@@ -86,6 +89,12 @@ STATIC ProcessGroup *OsCreateProcessGroup(UINT32 pid)
     group->groupID = pid;
     LOS_ListInit(&group->processList);
     LOS_ListInit(&group->exitProcessList);
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+    (VOID)memset_s(&group->bandwidth, sizeof(SchedBandwidth), 0, sizeof(SchedBandwidth));
+#endif
+#ifdef LOSCFG_KERNEL_CPUP
+    group->cpupTime = 0;
+#endif
 
     processCB = OS_PCB_FROM_PID(pid);
     LOS_ListTailInsert(&group->processList, &processCB->subordinateGroupList);
@@ -335,6 +344,28 @@ STATIC VOID OsWaitCheckAndWakeParentProcess(LosProcessCB *parentCB, const LosPro
     return;
 }
 
+#ifdef LOSCFG_KERNEL_VM
+STATIC VOID OsVforkWakeParent(LosProcessCB *processCB)
+{
+    LOS_DL_LIST *list = processCB->vforkWait;
+    LosTaskCB *taskCB = NULL;
+
+    if (list == NULL) {
+        return;
+    }
+
+    processCB->vforkWait = NULL;
+    while (!LOS_ListEmpty(list)) {
+        taskCB = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(list));
+        OsTaskWakeClearPendMask(taskCB);
+        OsSchedTaskWake(taskCB);
+    }
+#ifdef LOSCFG_KERNEL_SMP
+    LOS_MpSchedule(OS_MP_CPU_ALL);
+#endif
+}
+#endif
+
 LITE_OS_SEC_TEXT VOID OsProcessResourcesToFree(LosProcessCB *processCB)
 {
     if (!(processCB->processStatus & (OS_PROCESS_STATUS_INIT | OS_PROCESS_STATUS_RUNNING))) {
@@ -459,6 +490,9 @@ STATIC VOID OsProcessNaturalExit(LosTaskCB *runTask, UINT32 status)
         LOS_ListTailInsert(&processCB->group->exitProcessList, &processCB->subordinateGroupList);
 
         OsWaitCheckAndWakeParentProcess(parentCB, processCB);
+#ifdef LOSCFG_KERNEL_VM
+        OsVforkWakeParent(processCB);
+#endif
 
         OsDealAliveChildProcess(processCB);
 
@@ -530,7 +564,8 @@ LITE_OS_SEC_TEXT VOID OsProcessCBRecycleToFree(VOID)
         processCB->processStatus &= ~OS_PROCESS_FLAG_EXIT;
 #ifdef LOSCFG_KERNEL_VM
         LosVmSpace *space = NULL;
-        if (OsProcessIsUserMode(processCB)) {
+        /* a vfork child that never called exec is still on the address space of its parent */
+        if (OsProcessIsUserMode(processCB) && !(processCB->processStatus & OS_PROCESS_FLAG_VFORK)) {
             space = processCB->vmSpace;
         }
         processCB->vmSpace = NULL;
@@ -635,11 +670,17 @@ STATIC UINT32 OsInitPCB(LosProcessCB *processCB, UINT32 mode, UINT16 priority, c
     LOS_ListInit(&(processCB->waitList));
 
 #ifdef LOSCFG_KERNEL_VM
+    processCB->vforkWait = NULL;
     if (OsProcessIsUserMode(processCB)) {
-        processCB->vmSpace = OsCreateUserVmSpace();
-        if (processCB->vmSpace == NULL) {
-            processCB->processStatus = OS_PROCESS_FLAG_UNUSED;
-            return LOS_ENOMEM;
+        if (processCB->vmSpace != NULL) {
+            /* borrowed from the vfork parent, see OsForkInitPCB */
+            processCB->processStatus |= OS_PROCESS_FLAG_VFORK;
+        } else {
+            processCB->vmSpace = OsCreateUserVmSpace();
+            if (processCB->vmSpace == NULL) {
+                processCB->processStatus = OS_PROCESS_FLAG_UNUSED;
+                return LOS_ENOMEM;
+            }
         }
     } else {
         processCB->vmSpace = LOS_GetKVmSpace();
@@ -905,6 +946,72 @@ EXIT:
     return -ret;
 }
 
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+#define OS_SCHED_BANDWIDTH_PERIOD_MIN_US    1000U /* 1ms */
+#define OS_SCHED_BANDWIDTH_PERIOD_MAX_US    1000000U /* 1s */
+#define OS_SCHED_BANDWIDTH_US_TO_CYCLE(us)  (((UINT64)(us) * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE)
+#define OS_SCHED_BANDWIDTH_CYCLE_TO_US(cyc) (((cyc) * OS_NS_PER_CYCLE) / OS_SYS_NS_PER_US)
+
+/*
+ * Limit the fixed priority tasks of the user processes in a process group to quotaUs
+ * microseconds of cpu time, summed over all cpus, in every periodUs. A quota of 0 removes the limit.
+ */
+LITE_OS_SEC_TEXT INT32 OsSetProcessGroupBandwidth(UINT32 gid, UINT32 quotaUs, UINT32 periodUs)
+{
+    ProcessGroup *group = NULL;
+    UINT32 intSave;
+
+    if (OS_PID_CHECK_INVALID(gid) || (gid == OsGetKernelInitProcessID())) {
+        return -LOS_EINVAL;
+    }
+
+    if ((quotaUs != 0) && ((periodUs < OS_SCHED_BANDWIDTH_PERIOD_MIN_US) ||
+        (periodUs > OS_SCHED_BANDWIDTH_PERIOD_MAX_US) || (quotaUs > (periodUs * LOSCFG_KERNEL_CORE_NUM)))) {
+        return -LOS_EINVAL;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    group = OsFindProcessGroup(gid);
+    if ((group == NULL) || (group == g_processGroup)) {
+        SCHEDULER_UNLOCK(intSave);
+        return -LOS_ESRCH;
+    }
+
+    group->bandwidth.quota = OS_SCHED_BANDWIDTH_US_TO_CYCLE(quotaUs);
+    group->bandwidth.period = OS_SCHED_BANDWIDTH_US_TO_CYCLE(periodUs);
+    group->bandwidth.periodStart = OsGetCurrSchedTimeCycle();
+    LOS_Atomic64Set(&group->bandwidth.runtime, 0);
+    SCHEDULER_UNLOCK(intSave);
+    return LOS_OK;
+}
+
+LITE_OS_SEC_TEXT_MINOR VOID OsProcessGroupBandwidthShow(struct SeqBuf *seqBuf)
+{
+    ProcessGroup *group = NULL;
+    UINT32 intSave;
+
+    (VOID)LosBufPrintf(seqBuf, "%-6s %-10s %-10s %-10s %-12s %s\n",
+                       "pgid", "quota(us)", "period(us)", "runtime", "throttled", "total(us)");
+    SCHEDULER_LOCK(intSave);
+    LOS_DL_LIST_FOR_EACH_ENTRY(group, &g_processGroup->groupList, ProcessGroup, groupList) {
+        if (group->bandwidth.quota == 0) {
+            continue;
+        }
+        (VOID)LosBufPrintf(seqBuf, "%-6u %-10llu %-10llu %-10llu %-12u ", group->groupID,
+                           OS_SCHED_BANDWIDTH_CYCLE_TO_US(group->bandwidth.quota),
+                           OS_SCHED_BANDWIDTH_CYCLE_TO_US(group->bandwidth.period),
+                           OS_SCHED_BANDWIDTH_CYCLE_TO_US((UINT64)LOS_Atomic64Read(&group->bandwidth.runtime)),
+                           group->bandwidth.throttleCount);
+#ifdef LOSCFG_KERNEL_CPUP
+        (VOID)LosBufPrintf(seqBuf, "%llu\n", OS_SCHED_BANDWIDTH_CYCLE_TO_US(group->cpupTime));
+#else
+        (VOID)LosBufPrintf(seqBuf, "-\n");
+#endif
+    }
+    SCHEDULER_UNLOCK(intSave);
+}
+#endif
+
 LITE_OS_SEC_TEXT INT32 LOS_SetProcessScheduler(INT32 pid, UINT16 policy, UINT16 prio)
 {
     return OsSetProcessScheduler(LOS_PRIO_PROCESS, pid, prio, policy);
@@ -1698,6 +1805,11 @@ STATIC UINT32 OsCopyTask(UINT32 flags, LosProcessCB *childProcessCB, const CHAR
     if (OsProcessIsUserMode(childProcessCB)) {
         SCHEDULER_LOCK(intSave);
         OsUserCloneParentStack(childTaskCB->stackPointer, runTask->topOfStack, runTask->stackSize);
+        if (childProcessCB->processStatus & OS_PROCESS_FLAG_VFORK) {
+            /* the user stack is the parent's, the child must not unmap it when it exits */
+            childTaskCB->userMapBase = 0;
+            childTaskCB->userMapSize = 0;
+        }
         SCHEDULER_UNLOCK(intSave);
     }
     return LOS_OK;
@@ -1732,7 +1844,7 @@ STATIC UINT32 OsCopyMM(UINT32 flags, LosProcessCB *childProcessCB, LosProcessCB
     status_t status;
     UINT32 intSave;
 
-    if (!OsProcessIsUserMode(childProcessCB)) {
+    if (!OsProcessIsUserMode(childProcessCB) || (childProcessCB->processStatus & OS_PROCESS_FLAG_VFORK)) {
         return LOS_OK;
     }
 
@@ -1769,11 +1881,25 @@ STATIC UINT32 OsCopyFile(UINT32 flags, LosProcessCB *childProcessCB, LosProcessC
     return LOS_OK;
 }
 
+STATIC BOOL OsVforkShareSpace(UINT32 flags, const LosProcessCB *run)
+{
+    /*
+     * The child runs on the parent's space until exec or exit, the only parent thread is blocked
+     * meanwhile. Other threads could tear the space down under the child, so they get a full copy.
+     */
+    return ((flags & (CLONE_VFORK | CLONE_VM)) == (CLONE_VFORK | CLONE_VM)) && OsProcessIsUserMode(run) &&
+           (run->threadNumber == 1);
+}
+
 STATIC UINT32 OsForkInitPCB(UINT32 flags, LosProcessCB *child, const CHAR *name, UINTPTR sp, UINT32 size)
 {
     UINT32 ret;
     LosProcessCB *run = OsCurrProcessGet();
 
+    if (OsVforkShareSpace(flags, run)) {
+        child->vmSpace = run->vmSpace;
+    }
+
     ret = OsInitPCB(child, run->processMode, OS_PROCESS_PRIORITY_LOWEST, name);
     if (ret != LOS_OK) {
         return ret;
@@ -1839,10 +1965,44 @@ STATIC UINT32 OsCopyProcessResources(UINT32 flags, LosProcessCB *child, LosProce
     return LOS_OK;
 }
 
+STATIC VOID OsVforkWait(LosProcessCB *child)
+{
+    UINT32 intSave;
+
+    SCHEDULER_LOCK(intSave);
+    if (child->vforkWait != NULL) {
+        OsTaskWaitSetPendMask(OS_TASK_WAIT_VFORK, child->processID, LOS_WAIT_FOREVER);
+        (VOID)OsSchedTaskWait(child->vforkWait, LOS_WAIT_FOREVER, TRUE);
+    }
+    SCHEDULER_UNLOCK(intSave);
+}
+
+LITE_OS_SEC_TEXT BOOL OsProcessVforkRelease(LosProcessCB *processCB)
+{
+    UINT32 intSave;
+    BOOL borrowed = FALSE;
+
+    SCHEDULER_LOCK(intSave);
+    if (processCB->processStatus & OS_PROCESS_FLAG_VFORK) {
+        processCB->processStatus &= ~OS_PROCESS_FLAG_VFORK;
+        borrowed = TRUE;
+    }
+    OsVforkWakeParent(processCB);
+    SCHEDULER_UNLOCK(intSave);
+
+    return borrowed;
+}
+
 STATIC INT32 OsCopyProcess(UINT32 flags, const CHAR *name, UINTPTR sp, UINT32 size)
 {
     UINT32 intSave, ret, processID;
     LosProcessCB *run = OsCurrProcessGet();
+    LOS_DL_LIST vforkWait;
+
+    /* A vfork that can not borrow the space falls back to a plain fork, not to sharing the page table */
+    if ((flags & CLONE_VFORK) && !OsVforkShareSpace(flags, run)) {
+        flags &= ~CLONE_VM;
+    }
 
     LosProcessCB *child = OsGetFreePCB();
     if (child == NULL) {
@@ -1860,6 +2020,11 @@ STATIC INT32 OsCopyProcess(UINT32 flags, const CHAR *name, UINTPTR sp, UINT32 si
         goto ERROR_TASK;
     }
 
+    if (child->processStatus & OS_PROCESS_FLAG_VFORK) {
+        LOS_ListInit(&vforkWait);
+        child->vforkWait = &vforkWait;
+    }
+
     ret = OsChildSetProcessGroupAndSched(child, run);
     if (ret != LOS_OK) {
         goto ERROR_TASK;
@@ -1870,6 +2035,7 @@ STATIC INT32 OsCopyProcess(UINT32 flags, const CHAR *name, UINTPTR sp, UINT32 si
         LOS_Schedule();
     }
 
+    OsVforkWait(child);
     return processID;
 
 ERROR_TASK:
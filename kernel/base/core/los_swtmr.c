@@ -247,7 +247,6 @@ LITE_OS_SEC_TEXT VOID OsSwtmrScan(VOID)
 {
     Percpu *cpu = OsPercpuGet();
     SortLinkAttribute* swtmrSortLink = &OsPercpuGet()->swtmrSortLink;
-    LOS_DL_LIST *listObject = &swtmrSortLink->sortLink;
 
     /*
      * it needs to be carefully coped with, since the swtmr is in specific sortlink
@@ -255,29 +254,19 @@ LITE_OS_SEC_TEXT VOID OsSwtmrScan(VOID)
      */
     LOS_SpinLock(&cpu->swtmrSortLinkSpin);
 
-    if (LOS_ListEmpty(listObject)) {
-        LOS_SpinUnlock(&cpu->swtmrSortLinkSpin);
-        return;
-    }
-    SortLinkList *sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
-
     UINT64 currTime = OsGetCurrSchedTimeCycle();
-    while (sortList->responseTime <= currTime) {
-        sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
+    SortLinkList *sortList = OsSortLinkGetExpired(swtmrSortLink, currTime);
+    while (sortList != NULL) {
         SWTMR_CTRL_S *swtmr = LOS_DL_LIST_ENTRY(sortList, SWTMR_CTRL_S, stSortList);
         swtmr->startTime = GET_SORTLIST_VALUE(sortList);
         OsDeleteNodeSortLink(swtmrSortLink, sortList);
         LOS_SpinUnlock(&cpu->swtmrSortLinkSpin);
-        
+
         OsHookCall(LOS_HOOK_TYPE_SWTMR_EXPIRED, swtmr);
         OsWakePendTimeSwtmr(cpu, currTime, swtmr);
 
         LOS_SpinLock(&cpu->swtmrSortLinkSpin);
-        if (LOS_ListEmpty(listObject)) {
-            break;
-        }
-
-        sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
+        sortList = OsSortLinkGetExpired(swtmrSortLink, currTime);
     }
 
     LOS_SpinUnlock(&cpu->swtmrSortLinkSpin);
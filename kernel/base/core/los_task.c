@@ -489,6 +489,9 @@ LITE_OS_SEC_TEXT VOID OsTaskResourcesToFree(LosTaskCB *taskCB)
 #endif
 
     if (taskCB->taskStatus & OS_TASK_STATUS_UNUSED) {
+#ifdef LOSCFG_KERNEL_SYSCALL_ARENA
+        OsSyscallArenaRelease(&taskCB->arena);
+#endif
         topOfStack = taskCB->topOfStack;
         taskCB->topOfStack = 0;
 #ifdef LOSCFG_KERNEL_SMP_TASK_SYNC
@@ -523,6 +526,7 @@ LITE_OS_SEC_TEXT_INIT STATIC VOID OsTaskCBInitBase(LosTaskCB *taskCB,
 
 #ifdef LOSCFG_KERNEL_SMP
     taskCB->currCpu      = OS_TASK_INVALID_CPUID;
+    taskCB->lastCpu      = OS_TASK_INVALID_CPUID;
     taskCB->cpuAffiMask  = (initParam->usCpuAffiMask) ?
                             initParam->usCpuAffiMask : LOSCFG_KERNEL_CPU_MASK;
 #endif
@@ -1241,7 +1245,17 @@ LITE_OS_SEC_TEXT BOOL OsTaskCpuAffiSetUnsafe(UINT32 taskID, UINT16 newCpuAffiMas
 #ifdef LOSCFG_KERNEL_SMP
     LosTaskCB *taskCB = OS_TCB_FROM_TID(taskID);
 
+    if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
+        /* Requeue so the task moves to an allowed cpu and is visible to the cpus it may now run on */
+        OsSchedTaskDeQueue(taskCB);
+        taskCB->cpuAffiMask = newCpuAffiMask;
+        OsSchedTaskEnQueue(taskCB);
+        *oldCpuAffiMask = newCpuAffiMask;
+        return TRUE;
+    }
+
     taskCB->cpuAffiMask = newCpuAffiMask;
+
     *oldCpuAffiMask = CPUID_TO_AFFI_MASK(taskCB->currCpu);
     if (!((*oldCpuAffiMask) & newCpuAffiMask)) {
         taskCB->signal = SIGNAL_AFFI;
@@ -1602,6 +1616,7 @@ LOS_ERREND:
 LITE_OS_SEC_TEXT INT32 LOS_SetTaskScheduler(INT32 taskID, UINT16 policy, UINT16 priority)
 {
     UINT32 intSave;
+    UINT32 ret = LOS_OK;
     BOOL needSched = FALSE;
 
     if (OS_TID_CHECK_INVALID(taskID)) {
@@ -1612,13 +1627,31 @@ LITE_OS_SEC_TEXT INT32 LOS_SetTaskScheduler(INT32 taskID, UINT16 policy, UINT16
         return LOS_EINVAL;
     }
 
-    if ((policy != LOS_SCHED_FIFO) && (policy != LOS_SCHED_RR)) {
+    if ((policy != LOS_SCHED_FIFO) && (policy != LOS_SCHED_RR) && (policy != LOS_SCHED_DEADLINE)) {
         return LOS_EINVAL;
     }
 
     SCHEDULER_LOCK(intSave);
-    needSched = OsSchedModifyTaskSchedParam(OS_TCB_FROM_TID(taskID), policy, priority);
+    LosTaskCB *taskCB = OS_TCB_FROM_TID(taskID);
+    if (policy == LOS_SCHED_DEADLINE) {
+        /* Deadline tasks are ordered by the parameters set by LOS_SetTaskDeadline, not by priority */
+        UINT64 runtime = 0;
+        UINT64 deadline = 0;
+        UINT64 period = 0;
+        /* The idle task carries the system flag, none of them may be throttled by a budget */
+        if (taskCB->taskStatus & OS_TASK_FLAG_SYSTEM_TASK) {
+            SCHEDULER_UNLOCK(intSave);
+            return LOS_EPERM;
+        }
+        OsSchedGetTaskDeadlineParam(taskCB, &runtime, &deadline, &period);
+        ret = OsSchedModifyTaskDeadlineParam(taskCB, runtime, deadline, period, &needSched);
+    } else {
+        needSched = OsSchedModifyTaskSchedParam(taskCB, policy, priority);
+    }
     SCHEDULER_UNLOCK(intSave);
+    if (ret != LOS_OK) {
+        return (INT32)ret;
+    }
 
     LOS_MpSchedule(OS_MP_CPU_ALL);
     if (needSched && OS_SCHEDULER_ACTIVE) {
@@ -1628,6 +1661,66 @@ LITE_OS_SEC_TEXT INT32 LOS_SetTaskScheduler(INT32 taskID, UINT16 policy, UINT16
     return LOS_OK;
 }
 
+LITE_OS_SEC_TEXT INT32 LOS_SetTaskDeadline(INT32 taskID, UINT64 runtime, UINT64 deadline, UINT64 period)
+{
+    UINT32 intSave;
+    UINT32 ret;
+    BOOL needSched = FALSE;
+
+    if (OS_TID_CHECK_INVALID(taskID)) {
+        return LOS_ESRCH;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    LosTaskCB *taskCB = OS_TCB_FROM_TID(taskID);
+    if (taskCB->taskStatus & OS_TASK_STATUS_UNUSED) {
+        SCHEDULER_UNLOCK(intSave);
+        return LOS_ESRCH;
+    }
+
+    if (taskCB->taskStatus & OS_TASK_FLAG_SYSTEM_TASK) {
+        SCHEDULER_UNLOCK(intSave);
+        return LOS_EPERM;
+    }
+
+    ret = OsSchedModifyTaskDeadlineParam(taskCB, runtime, deadline, period, &needSched);
+    SCHEDULER_UNLOCK(intSave);
+    if (ret != LOS_OK) {
+        return (INT32)ret;
+    }
+
+    LOS_MpSchedule(OS_MP_CPU_ALL);
+    if (needSched && OS_SCHEDULER_ACTIVE) {
+        LOS_Schedule();
+    }
+
+    return LOS_OK;
+}
+
+LITE_OS_SEC_TEXT INT32 LOS_GetTaskDeadline(INT32 taskID, UINT64 *runtime, UINT64 *deadline, UINT64 *period)
+{
+    UINT32 intSave;
+
+    if (OS_TID_CHECK_INVALID(taskID)) {
+        return LOS_ESRCH;
+    }
+
+    if ((runtime == NULL) || (deadline == NULL) || (period == NULL)) {
+        return LOS_EINVAL;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    LosTaskCB *taskCB = OS_TCB_FROM_TID(taskID);
+    if (taskCB->taskStatus & OS_TASK_STATUS_UNUSED) {
+        SCHEDULER_UNLOCK(intSave);
+        return LOS_ESRCH;
+    }
+
+    OsSchedGetTaskDeadlineParam(taskCB, runtime, deadline, period);
+    SCHEDULER_UNLOCK(intSave);
+    return LOS_OK;
+}
+
 LITE_OS_SEC_TEXT UINT32 LOS_GetSystemTaskMaximum(VOID)
 {
     return g_taskMaxNum;
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LOS_ARENA_PRI_H
+#define _LOS_ARENA_PRI_H
+
+#include "los_typedef.h"
+#include "los_memory.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#ifdef LOSCFG_KERNEL_SYSCALL_ARENA
+/*
+ * Bump allocator for buffers that live no longer than the system call allocating them.
+ * Blocks are carved first from a small region in the stack frame of the syscall handler,
+ * then from a heap chunk kept by the task, and only then from the system heap.
+ * Everything carved from the arena is dropped when the system call returns.
+ */
+#define OS_SYSCALL_ARENA_FAST_SIZE  512
+#define OS_SYSCALL_ARENA_SIZE       0x1000
+
+typedef struct {
+    UINT8  *fastBase;   /**< Region on the syscall handler stack, NULL outside a system call */
+    UINT8  *chunkBase;  /**< Heap chunk of OS_SYSCALL_ARENA_SIZE kept for the life of the task */
+    UINT16 fastUsed;
+    UINT16 chunkUsed;
+} SyscallArena;
+
+extern VOID OsSyscallArenaEnter(UINT8 *fastBase);
+extern VOID OsSyscallArenaExit(VOID);
+extern VOID OsSyscallArenaRelease(SyscallArena *arena);
+extern VOID *OsSyscallArenaAlloc(size_t size);
+extern VOID OsSyscallArenaFree(VOID *ptr);
+#else
+STATIC INLINE VOID *OsSyscallArenaAlloc(size_t size)
+{
+    return LOS_MemAlloc(OS_SYS_MEM_ADDR, size);
+}
+
+STATIC INLINE VOID OsSyscallArenaFree(VOID *ptr)
+{
+    if (ptr != NULL) {
+        (VOID)LOS_MemFree(OS_SYS_MEM_ADDR, ptr);
+    }
+}
+#endif
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* _LOS_ARENA_PRI_H */
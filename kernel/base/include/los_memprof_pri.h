@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LOS_MEMPROF_PRI_H
+#define _LOS_MEMPROF_PRI_H
+
+#include "los_typedef.h"
+#include "los_hw_cpu.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+/*
+ * Sampling heap profiler of the kernel heap. Roughly one allocation is sampled for every
+ * g_memProfInterval bytes allocated, its call stack is recorded and the bytes it stands for
+ * stay charged to that call stack until the block is freed.
+ */
+struct SeqBuf;
+
+extern UINT32 g_memProfInterval;
+extern INT32 g_memProfBytesLeft[LOSCFG_KERNEL_CORE_NUM];
+
+extern BOOL OsMemProfRecord(const VOID *node, UINT32 size);
+extern VOID OsMemProfRelease(const VOID *node);
+extern UINT32 OsMemProfIntervalSet(UINT32 interval);
+extern VOID OsMemProfShow(struct SeqBuf *seqBuf);
+
+/* Returns TRUE if the block at node was sampled and must be released through OsMemProfRelease */
+STATIC INLINE BOOL OsMemProfSample(const VOID *node, UINT32 size)
+{
+    INT32 *bytesLeft = NULL;
+
+    if (g_memProfInterval == 0) {
+        return FALSE;
+    }
+
+    /* Unlocked, a task migrating in between only blurs the count of two cpus a little */
+    bytesLeft = &g_memProfBytesLeft[ArchCurrCpuid()];
+    *bytesLeft -= (INT32)size;
+    if (*bytesLeft > 0) {
+        return FALSE;
+    }
+
+    return OsMemProfRecord(node, size);
+}
+#endif
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* _LOS_MEMPROF_PRI_H */
@@ -46,6 +46,7 @@
 #include "vid_type.h"
 #endif
 #include "sys/resource.h"
+#include "los_atomic.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -68,11 +69,27 @@ typedef struct {
 } User;
 #endif
 
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+typedef struct {
+    UINT64      quota;           /**< Cpu time the group may use in each period, in cycles, 0 means no limit */
+    UINT64      period;          /**< Length of the period, in cycles */
+    UINT64      periodStart;     /**< Start time of the current period */
+    Atomic64    runtime;         /**< Cpu time used by the group in the current period */
+    UINT32      throttleCount;   /**< The number of times a task of the group was throttled */
+} SchedBandwidth;
+#endif
+
 typedef struct {
     UINT32      groupID;         /**< Process group ID is the PID of the process that created the group */
     LOS_DL_LIST processList;     /**< List of processes under this process group */
     LOS_DL_LIST exitProcessList; /**< List of closed processes (zombie processes) under this group */
     LOS_DL_LIST groupList;       /**< Process group list */
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+    SchedBandwidth bandwidth;    /**< Cpu bandwidth limit of the group */
+#endif
+#ifdef LOSCFG_KERNEL_CPUP
+    UINT64      cpupTime;        /**< Cpu time used by all processes of the group, in cycles */
+#endif
 } ProcessGroup;
 
 typedef struct ProcessCB {
@@ -107,6 +124,7 @@ typedef struct ProcessCB {
 #endif
 #ifdef LOSCFG_KERNEL_VM
     LosVmSpace           *vmSpace;     /**< VMM space for processes */
+    LOS_DL_LIST          *vforkWait;   /**< The parent task blocked in vfork until this process calls exec or exit */
 #endif
 #ifdef LOSCFG_FS_VFS
     struct files_struct  *files;       /**< Files held by the process */
@@ -232,6 +250,15 @@ typedef struct ProcessCB {
  */
 #define OS_PROCESS_FLAG_ALREADY_EXEC      0x1000U
 
+/**
+ * @ingroup los_process
+ * Flag that indicates the process or process control block status.
+ *
+ * The process was created by vfork and runs on the address space of its parent until it calls exec,
+ * a space that is not freed with the process.
+ */
+#define OS_PROCESS_FLAG_VFORK             0x2000U
+
 /**
  * @ingroup los_process
  * Flag that indicates the process or process control block status.
@@ -315,10 +342,11 @@ STATIC INLINE BOOL OsProcessIsUserMode(const LosProcessCB *processCB)
     return (processCB->processMode == OS_USER_MODE);
 }
 
-#define LOS_SCHED_NORMAL  0U
-#define LOS_SCHED_FIFO    1U
-#define LOS_SCHED_RR      2U
-#define LOS_SCHED_IDLE    3U
+#define LOS_SCHED_NORMAL    0U
+#define LOS_SCHED_FIFO      1U
+#define LOS_SCHED_RR        2U
+#define LOS_SCHED_IDLE      3U
+#define LOS_SCHED_DEADLINE  6U
 
 #define LOS_PRIO_PROCESS  0U
 #define LOS_PRIO_PGRP     1U
@@ -462,6 +490,7 @@ extern UINT32 OsUserInitProcess(VOID);
 extern VOID OsTaskSchedQueueDequeue(LosTaskCB *taskCB, UINT16 status);
 extern VOID OsTaskSchedQueueEnqueue(LosTaskCB *taskCB, UINT16 status);
 extern INT32 OsClone(UINT32 flags, UINTPTR sp, UINT32 size);
+extern BOOL OsProcessVforkRelease(LosProcessCB *processCB);
 extern UINT32 OsExecRecycleAndInit(LosProcessCB *processCB, const CHAR *name,
                                    LosVmSpace *oldAspace, UINTPTR oldFiles);
 extern UINT32 OsExecStart(const TSK_ENTRY_FUNC entry, UINTPTR sp, UINTPTR mapBase, UINT32 mapSize);
@@ -478,6 +507,11 @@ extern UINTPTR OsGetSigHandler(VOID);
 extern VOID OsWaitWakeTask(LosTaskCB *taskCB, UINT32 wakePID);
 extern INT32 OsSendSignalToProcessGroup(INT32 pid, siginfo_t *info, INT32 permission);
 extern INT32 OsSendSignalToAllProcess(siginfo_t *info, INT32 permission);
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+struct SeqBuf;
+extern INT32 OsSetProcessGroupBandwidth(UINT32 gid, UINT32 quotaUs, UINT32 periodUs);
+extern VOID OsProcessGroupBandwidthShow(struct SeqBuf *seqBuf);
+#endif
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -177,6 +177,20 @@ extern BOOL OsSchedModifyTaskSchedParam(LosTaskCB *taskCB, UINT16 policy, UINT16
 
 extern BOOL OsSchedModifyProcessSchedParam(LosProcessCB *processCB, UINT16 policy, UINT16 priority);
 
+extern UINT32 OsSchedDeadlineAdmit(const LosTaskCB *taskCB, UINT32 runtime, UINT32 deadline, UINT32 period);
+
+extern UINT32 OsSchedModifyTaskDeadlineParam(LosTaskCB *taskCB, UINT64 runtimeNs, UINT64 deadlineNs, UINT64 periodNs,
+                                             BOOL *needSched);
+
+extern VOID OsSchedGetTaskDeadlineParam(const LosTaskCB *taskCB, UINT64 *runtimeNs, UINT64 *deadlineNs,
+                                        UINT64 *periodNs);
+
+extern VOID OsSchedDeadlineRelease(LosTaskCB *taskCB);
+
+#ifdef LOSCFG_KERNEL_SMP
+extern UINT32 OsSchedPreemptMaskGet(VOID);
+#endif
+
 extern VOID OsSchedDelay(LosTaskCB *runTask, UINT32 tick);
 
 extern VOID OsSchedYield(VOID);
@@ -185,6 +199,21 @@ extern VOID OsSchedTaskExit(LosTaskCB *taskCB);
 
 extern VOID OsSchedTick(VOID);
 
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+typedef enum {
+    OS_SCHED_LAT_WAKEUP,     /* From a task being woken up to it running */
+    OS_SCHED_LAT_TIMESLICE,  /* Time a task runs before it is switched out */
+    OS_SCHED_LAT_TICK,       /* Tick interrupt arrival after its programmed response time */
+    OS_SCHED_LAT_PREEMPT,    /* From a preemption request to the context switch */
+    OS_SCHED_LAT_TYPE_MAX
+} SchedLatencyType;
+
+struct SeqBuf;
+extern VOID OsSchedLatencyRecord(SchedLatencyType type, UINT16 priority, UINT64 cycles);
+extern VOID OsSchedLatencyReset(VOID);
+extern VOID OsSchedLatencyShow(struct SeqBuf *seqBuf);
+#endif
+
 extern UINT32 OsSchedInit(VOID);
 
 extern VOID OsSchedStart(VOID);
@@ -199,10 +228,10 @@ extern VOID OsSchedResched(VOID);
 extern VOID OsSchedIrqEndCheckNeedSched(VOID);
 
 /*
-* This function inserts the runTask to the lock pending list based on the
-* task priority.
+* This function returns the position in the lock pending list where the runTask
+* is inserted by OsSchedTaskWait, based on the task priority.
 */
-extern LOS_DL_LIST *OsSchedLockPendFindPos(const LosTaskCB *runTask, LOS_DL_LIST *lockList);
+extern LOS_DL_LIST *OsSchedLockPendFindPos(LosTaskCB *runTask, LOS_DL_LIST *lockList);
 
 #ifdef LOSCFG_SCHED_TICK_DEBUG
 extern VOID OsSchedDebugRecordData(VOID);
@@ -55,9 +55,27 @@ typedef struct {
 #endif
 } SortLinkList;
 
+/*
+ * The sort link is a hierarchical timing wheel indexed by expiration tick. Each level
+ * splits the tick into OS_SORT_LINK_WHEEL_BITS wide digits, and a node lives on the
+ * level of the highest digit in which its tick differs from baseTick, so inserting
+ * and deleting a node is O(1) and nodes cascade down at most once per level.
+ */
+#define OS_SORT_LINK_WHEEL_BITS   5
+#define OS_SORT_LINK_WHEEL_SLOTS  (1U << OS_SORT_LINK_WHEEL_BITS)
+#define OS_SORT_LINK_WHEEL_MASK   (OS_SORT_LINK_WHEEL_SLOTS - 1)
+#define OS_SORT_LINK_WHEEL_LEVELS 8
+
+typedef struct {
+    LOS_DL_LIST slot[OS_SORT_LINK_WHEEL_SLOTS];
+    UINT32      bitmap;                             /* One bit per non-empty slot */
+} SortLinkWheel;
+
 typedef struct {
-    LOS_DL_LIST sortLink;
-    UINT32      nodeNum;
+    SortLinkWheel wheel[OS_SORT_LINK_WHEEL_LEVELS];
+    LOS_DL_LIST   overflow;                         /* Nodes beyond the reach of the top level */
+    UINT64        baseTick;                         /* No node expires before this tick */
+    UINT32        nodeNum;
 } SortLinkAttribute;
 
 #define OS_SORT_LINK_INVALID_TIME ((UINT64)-1)
@@ -67,6 +85,7 @@ typedef struct {
 extern UINT64 OsGetNextExpireTime(UINT64 startTime);
 extern UINT32 OsSortLinkInit(SortLinkAttribute *sortLinkHeader);
 extern VOID OsDeleteNodeSortLink(SortLinkAttribute *sortLinkHeader, SortLinkList *sortList);
+extern SortLinkList *OsSortLinkGetExpired(SortLinkAttribute *sortLinkHeader, UINT64 currTime);
 extern VOID OsAdd2SortLink(SortLinkList *node, UINT64 startTime, UINT32 waitTicks, SortLinkType type);
 extern VOID OsDeleteSortLink(SortLinkList *node, SortLinkType type);
 extern UINT32 OsSortLinkGetTargetExpireTime(const SortLinkList *targetSortList);
@@ -44,6 +44,9 @@
 #ifdef LOSCFG_KERNEL_CPUP
 #include "los_cpup_pri.h"
 #endif
+#ifdef LOSCFG_KERNEL_SYSCALL_ARENA
+#include "los_arena_pri.h"
+#endif
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -320,6 +323,13 @@ typedef struct {
     INT32           timeSlice;          /**< Task remaining time slice */
     UINT32          waitTimes;          /**< Task delay time, tick number */
     SortLinkList    sortList;           /**< Task sortlink node */
+    UINT32          dlRuntime;          /**< Deadline task runtime budget per period, in cycles */
+    UINT32          dlDeadline;         /**< Deadline task relative deadline, in cycles */
+    UINT32          dlPeriod;           /**< Deadline task replenishment period, in cycles */
+    UINT64          dlAbsDeadline;      /**< Deadline task absolute deadline of the current period */
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+    UINT64          wakeTime;           /**< Time this task was woken up, 0 once it has run */
+#endif
 
     UINT32          stackSize;          /**< Task stack size */
     UINTPTR         topOfStack;         /**< Task stack top */
@@ -331,6 +341,9 @@ typedef struct {
     UINTPTR         args[4];            /**< Parameter, of which the maximum number is 4 */
     CHAR            taskName[OS_TCB_NAME_LEN]; /**< Task name */
     LOS_DL_LIST     pendList;           /**< Task pend node */
+    LOS_DL_LIST     *pendHead;          /**< Head of the priority ordered lock pend list the task waits on */
+    LOS_DL_LIST     *pendGroupHead;     /**< First waiter of the same priority, valid on the last one */
+    LOS_DL_LIST     *pendGroupTail;     /**< Last waiter of the same priority, valid on the first one */
     LOS_DL_LIST     threadList;         /**< thread list */
     UINT32          eventMask;          /**< Event mask */
     UINT32          eventMode;          /**< Event mode */
@@ -346,6 +359,9 @@ typedef struct {
     UINT16          currCpu;            /**< CPU core number of this task is running on */
     UINT16          lastCpu;            /**< CPU core number of this task is running on last time */
     UINT16          cpuAffiMask;        /**< CPU affinity mask, support up to 16 cores */
+    UINT16          rqCpu;              /**< CPU core number of the run queue this task is ready on */
+    LOS_DL_LIST     stealList;          /**< Node on the run queue list of tasks other cpus may run */
+    UINT64          lastRunTime;        /**< Time this task was last switched out on lastCpu */
 #ifdef LOSCFG_KERNEL_SMP_TASK_SYNC
     UINT32          syncSignal;         /**< Synchronization for signal handling */
 #endif
@@ -371,6 +387,9 @@ typedef struct {
     LOS_DL_LIST     msgListHead;
     BOOL            accessMap[LOSCFG_BASE_CORE_TSK_LIMIT];
 #endif
+#ifdef LOSCFG_KERNEL_SYSCALL_ARENA
+    SyscallArena    arena;              /**< Scratch memory of the running system call */
+#endif
 } LosTaskCB;
 
 typedef struct {
@@ -494,6 +513,7 @@ STATIC INLINE BOOL OsTaskIsKilled(const LosTaskCB *taskCB)
 #define OS_TASK_WAIT_FUTEX      (OS_TASK_WAIT_MUTEX + 1)
 #define OS_TASK_WAIT_EVENT      (OS_TASK_WAIT_FUTEX + 1)
 #define OS_TASK_WAIT_COMPLETE   (OS_TASK_WAIT_EVENT + 1)
+#define OS_TASK_WAIT_VFORK      (OS_TASK_WAIT_COMPLETE + 1)
 
 STATIC INLINE VOID OsTaskWaitSetPendMask(UINT16 mask, UINTPTR lockID, UINT32 timeout)
 {
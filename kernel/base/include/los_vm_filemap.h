@@ -72,6 +72,8 @@ typedef struct MapInfo {
     LosArchMmu              *archMmu;
 } LosMapInfo;
 
+#define VM_FILE_PAGE_BATCH      16
+
 enum OsPageFlags {
     FILE_PAGE_FREE,
     FILE_PAGE_LOCKED,
@@ -80,6 +82,8 @@ enum OsPageFlags {
     FILE_PAGE_LRU,
     FILE_PAGE_ACTIVE,
     FILE_PAGE_SHARED,
+    FILE_PAGE_READAHEAD,
+    FILE_PAGE_ISOLATED,
 };
 
 #define PGOFF_MAX                       2000
@@ -122,6 +126,16 @@ STATIC INLINE VOID OsSetPageLRU(LosVmPage *page)
     LOS_BitmapSet(&page->flags, FILE_PAGE_LRU);
 }
 
+STATIC INLINE VOID OsCleanPageLRU(LosVmPage *page)
+{
+    LOS_BitmapClr(&page->flags, FILE_PAGE_LRU);
+}
+
+STATIC INLINE BOOL OsIsPageLRU(LosVmPage *page)
+{
+    return BIT_GET(page->flags, FILE_PAGE_LRU);
+}
+
 STATIC INLINE VOID OsSetPageFree(LosVmPage *page)
 {
     LOS_BitmapSet(&page->flags, FILE_PAGE_FREE);
@@ -183,18 +197,54 @@ STATIC INLINE BOOL OsIsPageShared(LosVmPage *page)
     return BIT_GET(page->flags, FILE_PAGE_SHARED);
 }
 
+/* Readahead marker, the next window is read in once a fault reaches this page */
+STATIC INLINE VOID OsSetPageReadahead(LosVmPage *page)
+{
+    LOS_BitmapSet(&page->flags, FILE_PAGE_READAHEAD);
+}
+
+STATIC INLINE VOID OsCleanPageReadahead(LosVmPage *page)
+{
+    LOS_BitmapClr(&page->flags, FILE_PAGE_READAHEAD);
+}
+
+STATIC INLINE BOOL OsIsPageReadahead(LosVmPage *page)
+{
+    return BIT_GET(page->flags, FILE_PAGE_READAHEAD);
+}
+
+/* Taken off the lru by compaction, the page sits on the private list of the evacuation pass */
+STATIC INLINE VOID OsSetPageIsolated(LosVmPage *page)
+{
+    LOS_BitmapSet(&page->flags, FILE_PAGE_ISOLATED);
+}
+
+STATIC INLINE VOID OsCleanPageIsolated(LosVmPage *page)
+{
+    LOS_BitmapClr(&page->flags, FILE_PAGE_ISOLATED);
+}
+
+STATIC INLINE BOOL OsIsPageIsolated(LosVmPage *page)
+{
+    return BIT_GET(page->flags, FILE_PAGE_ISOLATED);
+}
+
 INT32 OsVfsFileMmap(struct file *filep, LosVmMapRegion *region);
+VOID OsVmFileMapInit(VOID);
 LosFilePage *OsPageCacheAlloc(struct page_mapping *mapping, VM_OFFSET_T pgoff);
 LosFilePage *OsFindGetEntry(struct page_mapping *mapping, VM_OFFSET_T pgoff);
+UINT32 OsFindGetEntries(struct page_mapping *mapping, VM_OFFSET_T first, LosFilePage **fpages, UINT32 maxPages);
 LosMapInfo *OsGetMapInfo(LosFilePage *page, LosArchMmu *archMmu, VADDR_T vaddr);
 VOID OsAddMapInfo(LosFilePage *page, LosArchMmu *archMmu, VADDR_T vaddr);
 VOID OsDelMapInfo(LosVmMapRegion *region, LosVmPgFault *pgFault, BOOL cleanDirty);
 VOID OsFileCacheFlush(struct page_mapping *mapping);
 VOID OsFileCacheRemove(struct page_mapping *mapping);
 VOID OsUnmapPageLocked(LosFilePage *page, LosMapInfo *info);
+VOID OsMapInfoFree(LosMapInfo *info);
 VOID OsUnmapAllLocked(LosFilePage *page);
 VOID OsLruCacheAdd(LosFilePage *fpage, enum OsLruList lruType);
 VOID OsLruCacheDel(LosFilePage *fpage);
+UINT32 OsFilePagesEvacuate(LosVmPhysSeg *seg, LosVmPage *start, size_t nPages);
 LosFilePage *OsDumpDirtyPage(LosFilePage *oldPage);
 VOID OsDoFlushDirtyPage(LosFilePage *fpage);
 VOID OsDeletePageCacheLru(LosFilePage *page);
@@ -203,6 +253,15 @@ VOID OsPageRefDecNoLock(LosFilePage *page);
 VOID OsPageRefIncLocked(LosFilePage *page);
 int OsTryShrinkMemory(size_t nPage);
 VOID OsMarkPageDirty(LosFilePage *fpage, LosVmMapRegion *region, int off, int len);
+#ifdef LOSCFG_KERNEL_VM_READAHEAD
+#define VM_READAHEAD_PAGES_MAX  LOSCFG_KERNEL_VM_READAHEAD_MAX_PAGES
+UINT32 OsPageCacheReadPages(struct page_mapping *mapping, VM_OFFSET_T start, UINT32 nPages, VM_OFFSET_T marker);
+VOID OsVmReadahead(LosVmMapRegion *region, VM_OFFSET_T pgoff);
+#endif
+#ifdef LOSCFG_KERNEL_VM_FAULT_AROUND
+#define VM_FAULT_AROUND_PAGES   16 /* 64KB window, must be a power of two and fit in a UINT32 mask */
+VOID OsVmmFileFaultAround(LosVmMapRegion *region, LosVmPgFault *vmf);
+#endif
 
 typedef struct ProcessCB LosProcessCB;
 VOID OsVmmFileRegionFree(struct file *filep, LosProcessCB *processCB);
@@ -96,6 +96,14 @@ struct VmMapRegion {
             int f_oflags;
             struct Vnode *vnode;
             const LosVmFileOps *vmFOps;
+#ifdef LOSCFG_KERNEL_VM_READAHEAD
+            struct VmReadahead {
+                VM_OFFSET_T start;      /**< first page of the current readahead window */
+                UINT32 size;            /**< pages in the window */
+                UINT32 asyncSize;       /**< the marker sits asyncSize pages before the window end */
+                VM_OFFSET_T prevPgoff;  /**< page of the last fault */
+            } ra;
+#endif
         } rf;
         struct VmRegionAnon {
             LOS_DL_LIST  node;          /**< region LosVmPage list */
@@ -297,6 +305,7 @@ STATUS_T OsUnMMap(LosVmSpace *space, VADDR_T addr, size_t size);
  * it is used to malloc continuous virtual memory, no sure for continuous physical memory.
  */
 VOID *LOS_VMalloc(size_t size);
+VOID *LOS_VRealloc(VOID *addr, size_t size);
 VOID LOS_VFree(const VOID *addr);
 
 /**
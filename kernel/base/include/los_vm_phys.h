@@ -45,6 +45,8 @@ extern "C" {
 
 #define VM_LIST_ORDER_MAX    9
 #define VM_PHYS_SEG_MAX    32
+#define VM_PCP_HIGH        32   /* Single pages a cpu may cache before a batch goes back to the buddy lists */
+#define VM_PCP_BATCH       8    /* Pages moved between a cpu cache and the buddy lists at a time */
 
 #ifndef min
 #define min(x, y) ((x) < (y) ? (x) : (y))
@@ -60,6 +62,12 @@ struct VmFreeList {
     UINT32 listCnt;
 };
 
+struct VmPcpList {
+    SPIN_LOCK_S lock;
+    LOS_DL_LIST node;         /* Recently freed (cache hot) pages at the head, cold ones at the tail */
+    UINT32 count;
+};
+
 enum OsLruList {
     VM_LRU_INACTIVE_ANON = 0,
     VM_LRU_ACTIVE_ANON,
@@ -76,6 +84,10 @@ typedef struct VmPhysSeg {
 
     SPIN_LOCK_S freeListLock; /* The buddy list spinlock */
     struct VmFreeList freeList[VM_LIST_ORDER_MAX];  /* The free pages in the buddy list */
+    struct VmPcpList pcpList[LOSCFG_KERNEL_CORE_NUM]; /* Free single pages cached by each cpu */
+#ifdef LOSCFG_KERNEL_CMA
+    BOOL isCma;               /* Only movable pages and contiguous requests that failed elsewhere come from it */
+#endif
 
     SPIN_LOCK_S lruLock;
     size_t lruSize[VM_NR_LRU_LISTS];
@@ -91,6 +103,10 @@ extern struct VmPhysSeg g_vmPhysSeg[VM_PHYS_SEG_MAX];
 extern INT32 g_vmPhysSegNum;
 
 UINT32 OsVmPagesToOrder(size_t nPages);
+UINT32 OsVmPcpPagesGet(struct VmPhysSeg *seg);
+BOOL OsVmPcpDrainAll(VOID);
+LosVmPage *OsVmPhysSegPagesAlloc(struct VmPhysSeg *seg, size_t nPages);
+LosVmPage *OsVmPhysRangeAlloc(struct VmPhysSeg *seg, LosVmPage *start, size_t nPages);
 struct VmPhysSeg *OsVmPhysSegGet(LosVmPage *page);
 LosVmPhysSeg *OsGVmPhysSegGet(VOID);
 VOID *OsVmPageToVaddr(LosVmPage *page);
@@ -104,13 +120,39 @@ VOID OsVmPhysPagesFreeContiguous(LosVmPage *page, size_t nPages);
 LosVmPage *OsVmPhysToPage(paddr_t pa, UINT8 segID);
 
 LosVmPage *LOS_PhysPageAlloc(VOID);
+LosVmPage *LOS_PhysPageAllocZeroed(VOID);
+LosVmPage *LOS_PhysPageAllocMovable(VOID);
 VOID LOS_PhysPageFree(LosVmPage *page);
 size_t LOS_PhysPagesAlloc(size_t nPages, LOS_DL_LIST *list);
 size_t LOS_PhysPagesFree(LOS_DL_LIST *list);
 VOID *LOS_PhysPagesAllocContiguous(size_t nPages);
 VOID LOS_PhysPagesFreeContiguous(VOID *ptr, size_t nPages);
+STATUS_T LOS_PhysPagesResizeContiguous(VOID *ptr, size_t nPages);
 VADDR_T *LOS_PaddrToKVaddr(PADDR_T paddr);
 
+#ifdef LOSCFG_KERNEL_CMA
+LosVmPage *OsVmCmaPagesAlloc(size_t nPages);
+#endif
+
+#ifdef LOSCFG_KERNEL_VM_COMPACTION
+struct SeqBuf;
+
+UINT32 OsVmFragIndexGet(struct VmPhysSeg *seg, UINT32 order);
+BOOL OsVmCompact(UINT32 order);
+VOID OsVmCompactWakeup(VOID);
+UINT32 OsVmCompactThresholdSet(UINT32 threshold);
+VOID OsVmCompactShow(struct SeqBuf *seqBuf);
+#endif
+
+#ifdef LOSCFG_KERNEL_VM_ZERO_POOL
+struct SeqBuf;
+
+LosVmPage *OsVmZeroPoolGet(VOID);
+UINT32 OsVmZeroPoolShrink(VOID);
+UINT32 OsVmZeroPoolTargetSet(UINT32 pages);
+VOID OsVmZeroPoolShow(struct SeqBuf *seqBuf);
+#endif
+
 #ifdef __cplusplus
 #if __cplusplus
 }
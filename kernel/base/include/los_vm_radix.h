@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @defgroup los_vm_radix radix tree
+ * @ingroup kernel
+ */
+
+#ifndef __LOS_VM_RADIX_H__
+#define __LOS_VM_RADIX_H__
+
+#include "los_typedef.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#define VM_RADIX_SHIFT          4
+#define VM_RADIX_SLOTS          (1U << VM_RADIX_SHIFT)
+#define VM_RADIX_MASK           (VM_RADIX_SLOTS - 1)
+#define VM_RADIX_HEIGHT_MAX     ((32 + VM_RADIX_SHIFT - 1) / VM_RADIX_SHIFT)
+
+enum VmRadixTag {
+    VM_RADIX_TAG_DIRTY,
+    VM_RADIX_TAG_MAX,
+};
+
+typedef struct VmRadixNode {
+    VOID                *slots[VM_RADIX_SLOTS];
+    UINT16              tags[VM_RADIX_TAG_MAX]; /* slot bitmap, set when the subtree holds a tagged item */
+    UINT16              count;                  /* used slots */
+} VmRadixNode;
+
+/* A radix tree keyed by UINT32 indexes, all operations need the owner's lock held */
+typedef struct VmRadixTree {
+    VmRadixNode         *root;
+    UINT32              height;                 /* 0 when empty, a tree of height h holds indexes < 16^h */
+} VmRadixTree;
+
+STATIC INLINE VOID OsVmRadixTreeInit(VmRadixTree *tree)
+{
+    tree->root = NULL;
+    tree->height = 0;
+}
+
+STATIC INLINE BOOL OsVmRadixTreeEmpty(const VmRadixTree *tree)
+{
+    return (tree->root == NULL);
+}
+
+VOID OsVmRadixInit(VOID);
+STATUS_T OsVmRadixInsert(VmRadixTree *tree, UINT32 index, VOID *item);
+VOID *OsVmRadixDelete(VmRadixTree *tree, UINT32 index);
+VOID *OsVmRadixLookup(const VmRadixTree *tree, UINT32 index);
+UINT32 OsVmRadixGangLookup(const VmRadixTree *tree, VOID **results, UINT32 first, UINT32 maxItems);
+UINT32 OsVmRadixGangLookupTag(const VmRadixTree *tree, VOID **results, UINT32 first, UINT32 maxItems,
+                              enum VmRadixTag tag);
+VOID OsVmRadixTagSet(VmRadixTree *tree, UINT32 index, enum VmRadixTag tag);
+VOID OsVmRadixTagClear(VmRadixTree *tree, UINT32 index, enum VmRadixTag tag);
+BOOL OsVmRadixTagGet(const VmRadixTree *tree, UINT32 index, enum VmRadixTag tag);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* __LOS_VM_RADIX_H__ */
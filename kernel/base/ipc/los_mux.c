@@ -328,10 +328,6 @@ STATIC UINT32 OsMuxPendOp(LosTaskCB *runTask, LosMux *mutex, UINT32 timeout)
     owner = (LosTaskCB *)mutex->owner;
     runTask->taskMux = (VOID *)mutex;
     node = OsSchedLockPendFindPos(runTask, &mutex->muxList);
-    if (node == NULL) {
-        ret = LOS_NOK;
-        return ret;
-    }
 
     OsTaskWaitSetPendMask(OS_TASK_WAIT_MUTEX, (UINTPTR)mutex, timeout);
     ret = OsSchedTaskWait(node, timeout, TRUE);
@@ -386,6 +382,44 @@ UINT32 OsMuxTrylockUnsafe(LosMux *mutex, UINT32 timeout)
     return OsMuxPendOp(runTask, mutex, timeout);
 }
 
+#ifdef LOSCFG_KERNEL_MUX_ADAPTIVE_SPIN
+#define OS_MUX_SPIN_CYCLE_MAX ((20 * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE) /* 20us */
+
+/*
+ * A mutex held by a task running on another core is usually released soon, so it is
+ * cheaper to wait for it here than to pend and be woken again. The spinning stops when
+ * the owner goes off cpu, other tasks already pend on the mutex or the budget runs out.
+ */
+STATIC VOID OsMuxAdaptiveSpin(const LosMux *mutex, const LosTaskCB *runTask)
+{
+    volatile const LosMux *mux = mutex;
+    const LosTaskCB *owner = NULL;
+    UINT64 startTime;
+
+    /* LOS_MuxLock fails with the task lock held, there is no point in waiting for the owner */
+    if (!OsPreemptable()) {
+        return;
+    }
+
+    startTime = OsGetCurrSchedTimeCycle();
+    while (TRUE) {
+        owner = (const LosTaskCB *)mux->owner;
+        if ((owner == NULL) || (owner == runTask) || (mux->muxList.pstNext != &mutex->muxList)) {
+            return;
+        }
+
+        if (!(*(volatile UINT16 *)&owner->taskStatus & OS_TASK_STATUS_RUNNING) ||
+            (*(volatile UINT16 *)&owner->currCpu == ArchCurrCpuid())) {
+            return;
+        }
+
+        if ((OsGetCurrSchedTimeCycle() - startTime) >= OS_MUX_SPIN_CYCLE_MAX) {
+            return;
+        }
+    }
+}
+#endif
+
 LITE_OS_SEC_TEXT UINT32 LOS_MuxLock(LosMux *mutex, UINT32 timeout)
 {
     LosTaskCB *runTask = NULL;
@@ -407,6 +441,12 @@ LITE_OS_SEC_TEXT UINT32 LOS_MuxLock(LosMux *mutex, UINT32 timeout)
         OsBackTrace();
     }
 
+#ifdef LOSCFG_KERNEL_MUX_ADAPTIVE_SPIN
+    if ((timeout != 0) && (mutex->magic == OS_MUX_MAGIC)) {
+        OsMuxAdaptiveSpin(mutex, runTask);
+    }
+#endif
+
     SCHEDULER_LOCK(intSave);
     ret = OsMuxLockUnsafe(mutex, timeout);
     SCHEDULER_UNLOCK(intSave);
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_arena_pri.h"
+#include "los_task_pri.h"
+#include "los_hwi.h"
+
+#ifdef LOSCFG_KERNEL_SYSCALL_ARENA
+#define OS_ARENA_ALIGN_SIZE     8
+#define OS_ARENA_BLOCK_MAGIC    0xA4E2B10C
+
+typedef struct {
+    UINT32 size;    /* Bytes the block takes in the arena, header included */
+    UINT32 magic;
+} ArenaBlockHead;
+
+STATIC VOID *OsArenaBump(UINT8 *base, UINT16 *used, UINT32 limit, UINT32 blkSize)
+{
+    ArenaBlockHead *head = NULL;
+
+    if ((base == NULL) || (blkSize > (limit - *used))) {
+        return NULL;
+    }
+
+    head = (ArenaBlockHead *)(base + *used);
+    head->size = blkSize;
+    head->magic = OS_ARENA_BLOCK_MAGIC;
+    *used += blkSize;
+    return (VOID *)(head + 1);
+}
+
+STATIC BOOL OsArenaRewind(UINT8 *base, UINT16 *used, UINT32 limit, VOID *ptr)
+{
+    ArenaBlockHead *head = (ArenaBlockHead *)ptr - 1;
+
+    if ((base == NULL) || ((UINT8 *)ptr <= base) || ((UINT8 *)ptr >= (base + limit))) {
+        return FALSE;
+    }
+
+    LOS_ASSERT(head->magic == OS_ARENA_BLOCK_MAGIC);
+    /* Only the last block gives its room back, the rest waits for the end of the system call */
+    if (((UINT8 *)head + head->size) == (base + *used)) {
+        *used -= head->size;
+    }
+    return TRUE;
+}
+
+VOID OsSyscallArenaEnter(UINT8 *fastBase)
+{
+    SyscallArena *arena = &OsCurrTaskGet()->arena;
+
+    arena->fastBase = fastBase;
+    arena->fastUsed = 0;
+    arena->chunkUsed = 0;
+}
+
+VOID OsSyscallArenaExit(VOID)
+{
+    SyscallArena *arena = &OsCurrTaskGet()->arena;
+
+    arena->fastBase = NULL;
+    arena->fastUsed = 0;
+    arena->chunkUsed = 0;
+}
+
+VOID OsSyscallArenaRelease(SyscallArena *arena)
+{
+    UINT8 *chunk = arena->chunkBase;
+
+    arena->chunkBase = NULL;
+    arena->chunkUsed = 0;
+    if (chunk != NULL) {
+        (VOID)LOS_MemFree(OS_SYS_MEM_ADDR, chunk);
+    }
+}
+
+VOID *OsSyscallArenaAlloc(size_t size)
+{
+    SyscallArena *arena = NULL;
+    VOID *ptr = NULL;
+    UINT32 blkSize;
+
+    if ((size == 0) || (size > (OS_SYSCALL_ARENA_SIZE - sizeof(ArenaBlockHead))) || OS_INT_ACTIVE) {
+        return LOS_MemAlloc(OS_SYS_MEM_ADDR, size);
+    }
+
+    arena = &OsCurrTaskGet()->arena;
+    if (arena->fastBase == NULL) {
+        return LOS_MemAlloc(OS_SYS_MEM_ADDR, size);
+    }
+
+    blkSize = ALIGN(size + sizeof(ArenaBlockHead), OS_ARENA_ALIGN_SIZE);
+    ptr = OsArenaBump(arena->fastBase, &arena->fastUsed, OS_SYSCALL_ARENA_FAST_SIZE, blkSize);
+    if (ptr != NULL) {
+        return ptr;
+    }
+
+    if (arena->chunkBase == NULL) {
+        arena->chunkBase = (UINT8 *)LOS_MemAllocAlign(OS_SYS_MEM_ADDR, OS_SYSCALL_ARENA_SIZE, OS_ARENA_ALIGN_SIZE);
+    }
+    ptr = OsArenaBump(arena->chunkBase, &arena->chunkUsed, OS_SYSCALL_ARENA_SIZE, blkSize);
+    if (ptr != NULL) {
+        return ptr;
+    }
+
+    return LOS_MemAlloc(OS_SYS_MEM_ADDR, size);
+}
+
+VOID OsSyscallArenaFree(VOID *ptr)
+{
+    SyscallArena *arena = NULL;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    arena = &OsCurrTaskGet()->arena;
+    if (OsArenaRewind(arena->fastBase, &arena->fastUsed, OS_SYSCALL_ARENA_FAST_SIZE, ptr) ||
+        OsArenaRewind(arena->chunkBase, &arena->chunkUsed, OS_SYSCALL_ARENA_SIZE, ptr)) {
+        return;
+    }
+
+    (VOID)LOS_MemFree(OS_SYS_MEM_ADDR, ptr);
+}
+#endif
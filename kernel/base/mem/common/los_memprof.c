@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_memprof_pri.h"
+#include "los_spinlock.h"
+#include "los_exc.h"
+#include "los_seq_buf.h"
+#include "securec.h"
+
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+#define OS_MEM_PROF_DEPTH           8
+#define OS_MEM_PROF_OMIT_LR         2           /* frames of the profiler and the allocator */
+#define OS_MEM_PROF_SITE_NUM        256         /* distinct call stacks, a power of two */
+#define OS_MEM_PROF_LIVE_NUM        1024        /* sampled blocks not freed yet */
+#define OS_MEM_PROF_LIVE_HASH_NUM   256         /* a power of two */
+#define OS_MEM_PROF_INTERVAL        (512 * 1024)
+#define OS_MEM_PROF_INTERVAL_MIN    1024
+#define OS_MEM_PROF_INTERVAL_MAX    0x10000000  /* keeps the gap to the next sample within an INT32 */
+
+typedef struct {
+    UINTPTR linkReg[OS_MEM_PROF_DEPTH];
+    UINT32 allocCount;          /* samples taken on this stack, 0 for an unused slot */
+    UINT32 liveCount;           /* samples not freed yet */
+    UINT64 liveBytes;           /* bytes the live samples stand for */
+} MemProfSite;
+
+typedef struct {
+    const VOID *node;
+    UINT32 weight;              /* bytes the sample stands for */
+    UINT16 site;
+    UINT16 next;                /* index + 1 of the next entry in the hash chain or the free list */
+} MemProfLive;
+
+UINT32 g_memProfInterval = OS_MEM_PROF_INTERVAL;
+INT32 g_memProfBytesLeft[LOSCFG_KERNEL_CORE_NUM];
+
+LITE_OS_SEC_BSS STATIC SPIN_LOCK_INIT(g_memProfSpin);
+LITE_OS_SEC_BSS STATIC MemProfSite g_memProfSite[OS_MEM_PROF_SITE_NUM];
+LITE_OS_SEC_BSS STATIC MemProfLive g_memProfLive[OS_MEM_PROF_LIVE_NUM];
+LITE_OS_SEC_BSS STATIC UINT16 g_memProfLiveHash[OS_MEM_PROF_LIVE_HASH_NUM];
+LITE_OS_SEC_BSS STATIC UINT16 g_memProfLiveFree;   /* index + 1 of the first released entry */
+LITE_OS_SEC_BSS STATIC UINT16 g_memProfLiveUsed;   /* entries handed out at least once */
+LITE_OS_SEC_BSS STATIC UINT32 g_memProfSeed[LOSCFG_KERNEL_CORE_NUM];
+LITE_OS_SEC_BSS STATIC BOOL g_memProfFullWarned;
+
+/*
+ * Spread the gap to the next sample over [interval / 2, interval * 3 / 2) so periodic
+ * allocation patterns cannot hide behind a fixed stride.
+ */
+STATIC UINT32 OsMemProfNextGap(UINT32 cpuid, UINT32 interval)
+{
+    UINT32 seed = g_memProfSeed[cpuid];
+
+    if (seed == 0) {
+        seed = (cpuid + 1) * 0x9E3779B9U; /* 0x9E3779B9: golden ratio, any odd constant works */
+    }
+    seed ^= seed << 13; /* 13, 17, 5: xorshift32 */
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    g_memProfSeed[cpuid] = seed;
+
+    return (interval >> 1) + (seed % interval);
+}
+
+STATIC INLINE UINT32 OsMemProfLiveHash(const VOID *node)
+{
+    UINTPTR addr = (UINTPTR)node >> 3; /* 3: heap blocks are at least 8 bytes apart */
+
+    return (UINT32)(addr ^ (addr >> 8)) & (OS_MEM_PROF_LIVE_HASH_NUM - 1);
+}
+
+STATIC UINT32 OsMemProfSiteGet(const UINTPTR *linkReg)
+{
+    UINT32 hash = 0;
+    UINT32 index, count;
+
+    for (index = 0; index < OS_MEM_PROF_DEPTH; index++) {
+        hash = (hash * 31) + (UINT32)linkReg[index]; /* 31: the usual multiplier of a string hash */
+    }
+
+    for (count = 0; count < OS_MEM_PROF_SITE_NUM; count++) {
+        index = (hash + count) & (OS_MEM_PROF_SITE_NUM - 1);
+        if (g_memProfSite[index].allocCount == 0) {
+            (VOID)memcpy_s(g_memProfSite[index].linkReg, sizeof(g_memProfSite[index].linkReg),
+                           linkReg, sizeof(g_memProfSite[index].linkReg));
+            return index;
+        }
+        if (memcmp(g_memProfSite[index].linkReg, linkReg, sizeof(g_memProfSite[index].linkReg)) == 0) {
+            return index;
+        }
+    }
+
+    return OS_MEM_PROF_SITE_NUM;
+}
+
+STATIC UINT16 OsMemProfLiveGet(VOID)
+{
+    UINT16 index = g_memProfLiveFree;
+
+    if (index != 0) {
+        g_memProfLiveFree = g_memProfLive[index - 1].next;
+        return index;
+    }
+
+    if (g_memProfLiveUsed < OS_MEM_PROF_LIVE_NUM) {
+        return ++g_memProfLiveUsed;
+    }
+
+    return 0;
+}
+
+BOOL OsMemProfRecord(const VOID *node, UINT32 size)
+{
+    UINTPTR linkReg[OS_MEM_PROF_DEPTH] = { 0 };
+    UINT32 interval = g_memProfInterval;
+    UINT32 cpuid = ArchCurrCpuid();
+    UINT32 siteIndex, hash, intSave;
+    UINT16 liveIndex;
+    MemProfLive *live = NULL;
+
+    if (interval == 0) {
+        return FALSE;
+    }
+    g_memProfBytesLeft[cpuid] = (INT32)OsMemProfNextGap(cpuid, interval);
+
+    LOS_RecordLR(linkReg, OS_MEM_PROF_DEPTH, OS_MEM_PROF_DEPTH, OS_MEM_PROF_OMIT_LR);
+
+    LOS_SpinLockSave(&g_memProfSpin, &intSave);
+    siteIndex = OsMemProfSiteGet(linkReg);
+    liveIndex = (siteIndex < OS_MEM_PROF_SITE_NUM) ? OsMemProfLiveGet() : 0;
+    if (liveIndex == 0) {
+        BOOL warn = !g_memProfFullWarned;
+        g_memProfFullWarned = TRUE;
+        LOS_SpinUnlockRestore(&g_memProfSpin, intSave);
+        if (warn) {
+            PRINT_WARN("memprof: sample table full, raise the sampling interval\n");
+        }
+        return FALSE;
+    }
+
+    /* A block smaller than the interval is sampled with a chance of about size / interval */
+    live = &g_memProfLive[liveIndex - 1];
+    live->node = node;
+    live->weight = (size > interval) ? size : interval;
+    live->site = (UINT16)siteIndex;
+    hash = OsMemProfLiveHash(node);
+    live->next = g_memProfLiveHash[hash];
+    g_memProfLiveHash[hash] = liveIndex;
+
+    g_memProfSite[siteIndex].allocCount++;
+    g_memProfSite[siteIndex].liveCount++;
+    g_memProfSite[siteIndex].liveBytes += live->weight;
+    LOS_SpinUnlockRestore(&g_memProfSpin, intSave);
+
+    return TRUE;
+}
+
+VOID OsMemProfRelease(const VOID *node)
+{
+    MemProfLive *live = NULL;
+    MemProfSite *site = NULL;
+    UINT16 *prev = NULL;
+    UINT16 index;
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&g_memProfSpin, &intSave);
+    prev = &g_memProfLiveHash[OsMemProfLiveHash(node)];
+    while (*prev != 0) {
+        index = *prev;
+        live = &g_memProfLive[index - 1];
+        if (live->node != node) {
+            prev = &live->next;
+            continue;
+        }
+
+        site = &g_memProfSite[live->site];
+        site->liveCount--;
+        site->liveBytes -= live->weight;
+        *prev = live->next;
+        live->node = NULL;
+        live->next = g_memProfLiveFree;
+        g_memProfLiveFree = index;
+        break;
+    }
+    LOS_SpinUnlockRestore(&g_memProfSpin, intSave);
+}
+
+UINT32 OsMemProfIntervalSet(UINT32 interval)
+{
+    UINT32 cpuid;
+
+    if ((interval != 0) && ((interval < OS_MEM_PROF_INTERVAL_MIN) || (interval > OS_MEM_PROF_INTERVAL_MAX))) {
+        return LOS_NOK;
+    }
+
+    g_memProfInterval = interval;
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        g_memProfBytesLeft[cpuid] = (INT32)interval;
+    }
+    return LOS_OK;
+}
+
+/*
+ * One line per call stack in folded format, outermost caller first, followed by the estimated
+ * live bytes: "0xc0012345;0xc0023456;0xc0034567 1048576". Feed it to flamegraph.pl after
+ * resolving the addresses with addr2line against the kernel image.
+ */
+VOID OsMemProfShow(struct SeqBuf *seqBuf)
+{
+    MemProfSite site;
+    UINT32 index, intSave;
+    INT32 depth;
+    BOOL first;
+
+    for (index = 0; index < OS_MEM_PROF_SITE_NUM; index++) {
+        /* Copied out, printing may allocate and so land in the profiler again */
+        LOS_SpinLockSave(&g_memProfSpin, &intSave);
+        site = g_memProfSite[index];
+        LOS_SpinUnlockRestore(&g_memProfSpin, intSave);
+        if (site.liveCount == 0) {
+            continue;
+        }
+
+        first = TRUE;
+        for (depth = OS_MEM_PROF_DEPTH - 1; depth >= 0; depth--) {
+            if (site.linkReg[depth] == 0) {
+                continue;
+            }
+            (VOID)LosBufPrintf(seqBuf, first ? "%#x" : ";%#x", site.linkReg[depth]);
+            first = FALSE;
+        }
+        (VOID)LosBufPrintf(seqBuf, "%s %llu\n", first ? "[unknown]" : "", site.liveBytes);
+    }
+}
+#endif
@@ -31,7 +31,6 @@
 
 #include "los_membox.h"
 #include "los_hwi.h"
-#include "los_spinlock.h"
 
 
 #ifdef LOSCFG_AARCH64
@@ -48,10 +47,33 @@
     ((VOID *)((UINT8 *)(addr) + OS_MEMBOX_NODE_HEAD_SIZE))
 #define OS_MEMBOX_NODE_ADDR(addr) \
     ((LOS_MEMBOX_NODE *)(VOID *)((UINT8 *)(addr) - OS_MEMBOX_NODE_HEAD_SIZE))
-/* spinlock for mem module, only available on SMP mode */
-LITE_OS_SEC_BSS  SPIN_LOCK_INIT(g_memboxSpin);
-#define MEMBOX_LOCK(state)       LOS_SpinLockSave(&g_memboxSpin, &(state))
-#define MEMBOX_UNLOCK(state)     LOS_SpinUnlockRestore(&g_memboxSpin, (state))
+/*
+ * The free list head packs the index of the first free block (+1, 0 for an empty list) in the low
+ * bits and a tag in the high bits. Every push and pop bumps the tag, so a compare-and-swap against
+ * a head read before another cpu popped and pushed the same block fails instead of corrupting the list.
+ */
+#define OS_MEMBOX_INDEX_BITS    16
+#define OS_MEMBOX_INDEX_MASK    ((1U << OS_MEMBOX_INDEX_BITS) - 1)
+#define OS_MEMBOX_TAG_ONE       (1U << OS_MEMBOX_INDEX_BITS)
+#define OS_MEMBOX_BLK_NUM_MAX   OS_MEMBOX_INDEX_MASK
+#define OS_MEMBOX_HEAD(head, index) \
+    (INT32)((((UINT32)(head) + OS_MEMBOX_TAG_ONE) & ~OS_MEMBOX_INDEX_MASK) | (index))
+
+STATIC INLINE LOS_MEMBOX_NODE *OsMemboxIndexToNode(const LOS_MEMBOX_INFO *boxInfo, UINT32 index)
+{
+    if (index == 0) {
+        return NULL;
+    }
+    return (LOS_MEMBOX_NODE *)(VOID *)((UINT8 *)(boxInfo + 1) + ((index - 1) * boxInfo->uwBlkSize));
+}
+
+STATIC INLINE UINT32 OsMemboxNodeToIndex(const LOS_MEMBOX_INFO *boxInfo, const LOS_MEMBOX_NODE *node)
+{
+    if (node == NULL) {
+        return 0;
+    }
+    return (((UINT32)((UINTPTR)node - (UINTPTR)(boxInfo + 1)) / boxInfo->uwBlkSize) + 1) & OS_MEMBOX_INDEX_MASK;
+}
 
 STATIC INLINE UINT32 OsCheckBoxMem(const LOS_MEMBOX_INFO *boxInfo, const VOID *node)
 {
@@ -78,7 +100,6 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_MemboxInit(VOID *pool, UINT32 poolSize, UINT32
     LOS_MEMBOX_INFO *boxInfo = (LOS_MEMBOX_INFO *)pool;
     LOS_MEMBOX_NODE *node = NULL;
     UINT32 index;
-    UINT32 intSave;
 
     if (pool == NULL) {
         return LOS_NOK;
@@ -92,18 +113,19 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_MemboxInit(VOID *pool, UINT32 poolSize, UINT32
         return LOS_NOK;
     }
 
-    MEMBOX_LOCK(intSave);
     boxInfo->uwBlkSize = LOS_MEMBOX_ALLIGNED(blkSize + OS_MEMBOX_NODE_HEAD_SIZE);
     boxInfo->uwBlkNum = (poolSize - sizeof(LOS_MEMBOX_INFO)) / boxInfo->uwBlkSize;
     boxInfo->uwBlkCnt = 0;
     if (boxInfo->uwBlkNum == 0) {
-        MEMBOX_UNLOCK(intSave);
         return LOS_NOK;
     }
 
-    node = (LOS_MEMBOX_NODE *)(boxInfo + 1);
+    /* blocks past what the head can index are left unused */
+    if (boxInfo->uwBlkNum > OS_MEMBOX_BLK_NUM_MAX) {
+        boxInfo->uwBlkNum = OS_MEMBOX_BLK_NUM_MAX;
+    }
 
-    boxInfo->stFreeList.pstNext = node;
+    node = (LOS_MEMBOX_NODE *)(boxInfo + 1);
 
     for (index = 0; index < boxInfo->uwBlkNum - 1; ++index) {
         node->pstNext = OS_MEMBOX_NEXT(node, boxInfo->uwBlkSize);
@@ -112,7 +134,8 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_MemboxInit(VOID *pool, UINT32 poolSize, UINT32
 
     node->pstNext = NULL;
 
-    MEMBOX_UNLOCK(intSave);
+    DMB;
+    LOS_AtomicSet(&boxInfo->uwFreeHead, 1);
 
     return LOS_OK;
 }
@@ -121,51 +144,63 @@ LITE_OS_SEC_TEXT VOID *LOS_MemboxAlloc(VOID *pool)
 {
     LOS_MEMBOX_INFO *boxInfo = (LOS_MEMBOX_INFO *)pool;
     LOS_MEMBOX_NODE *node = NULL;
-    LOS_MEMBOX_NODE *nodeTmp = NULL;
+    INT32 head, newHead;
     UINT32 intSave;
 
     if (pool == NULL) {
         return NULL;
     }
 
-    MEMBOX_LOCK(intSave);
-    node = &(boxInfo->stFreeList);
-    if (node->pstNext != NULL) {
-        nodeTmp = node->pstNext;
-        node->pstNext = nodeTmp->pstNext;
-        OS_MEMBOX_SET_MAGIC(nodeTmp);
-        boxInfo->uwBlkCnt++;
+    /* Interrupts stay off so the head cannot go stale on this cpu while it is being swapped */
+    intSave = LOS_IntLock();
+    do {
+        head = LOS_AtomicRead(&boxInfo->uwFreeHead);
+        node = OsMemboxIndexToNode(boxInfo, (UINT32)head & OS_MEMBOX_INDEX_MASK);
+        if (node == NULL) {
+            break;
+        }
+        /* the link may be stale if another cpu took the block, the tag then fails the swap */
+        newHead = OS_MEMBOX_HEAD(head, OsMemboxNodeToIndex(boxInfo, node->pstNext));
+    } while (LOS_AtomicCmpXchg32bits(&boxInfo->uwFreeHead, newHead, head));
+
+    if (node != NULL) {
+        DMB;
+        OS_MEMBOX_SET_MAGIC(node);
+        LOS_AtomicInc((Atomic *)&boxInfo->uwBlkCnt);
     }
-    MEMBOX_UNLOCK(intSave);
+    LOS_IntRestore(intSave);
 
-    return (nodeTmp == NULL) ? NULL : OS_MEMBOX_USER_ADDR(nodeTmp);
+    return (node == NULL) ? NULL : OS_MEMBOX_USER_ADDR(node);
 }
 
 LITE_OS_SEC_TEXT UINT32 LOS_MemboxFree(VOID *pool, VOID *box)
 {
     LOS_MEMBOX_INFO *boxInfo = (LOS_MEMBOX_INFO *)pool;
-    UINT32 ret = LOS_NOK;
+    LOS_MEMBOX_NODE *node = NULL;
+    INT32 head, newHead;
     UINT32 intSave;
 
     if ((pool == NULL) || (box == NULL)) {
         return LOS_NOK;
     }
 
-    MEMBOX_LOCK(intSave);
-    do {
-        LOS_MEMBOX_NODE *node = OS_MEMBOX_NODE_ADDR(box);
-        if (OsCheckBoxMem(boxInfo, node) != LOS_OK) {
-            break;
-        }
+    node = OS_MEMBOX_NODE_ADDR(box);
+    if (OsCheckBoxMem(boxInfo, node) != LOS_OK) {
+        return LOS_NOK;
+    }
 
-        node->pstNext = boxInfo->stFreeList.pstNext;
-        boxInfo->stFreeList.pstNext = node;
-        boxInfo->uwBlkCnt--;
-        ret = LOS_OK;
-    } while (0);
-    MEMBOX_UNLOCK(intSave);
+    intSave = LOS_IntLock();
+    do {
+        head = LOS_AtomicRead(&boxInfo->uwFreeHead);
+        node->pstNext = OsMemboxIndexToNode(boxInfo, (UINT32)head & OS_MEMBOX_INDEX_MASK);
+        newHead = OS_MEMBOX_HEAD(head, OsMemboxNodeToIndex(boxInfo, node));
+        /* the link must be visible before the block is published on the list */
+        DMB;
+    } while (LOS_AtomicCmpXchg32bits(&boxInfo->uwFreeHead, newHead, head));
+    LOS_AtomicDec((Atomic *)&boxInfo->uwBlkCnt);
+    LOS_IntRestore(intSave);
 
-    return ret;
+    return LOS_OK;
 }
 
 LITE_OS_SEC_TEXT_MINOR VOID LOS_MemboxClr(VOID *pool, VOID *box)
@@ -190,12 +225,16 @@ LITE_OS_SEC_TEXT_MINOR VOID LOS_ShowBox(VOID *pool)
     if (pool == NULL) {
         return;
     }
-    MEMBOX_LOCK(intSave);
+    intSave = LOS_IntLock();
     PRINT_INFO("membox(%p,0x%x,0x%x):\r\n", pool, boxInfo->uwBlkSize, boxInfo->uwBlkNum);
     PRINT_INFO("free node list:\r\n");
 
-    for (node = boxInfo->stFreeList.pstNext, index = 0; node != NULL;
-         node = node->pstNext, ++index) {
+    /* a snapshot only, bounded in case other cpus change the list underneath */
+    node = OsMemboxIndexToNode(boxInfo, (UINT32)LOS_AtomicRead(&boxInfo->uwFreeHead) & OS_MEMBOX_INDEX_MASK);
+    for (index = 0; (node != NULL) && (index < boxInfo->uwBlkNum); node = node->pstNext, ++index) {
+        if (OsMemboxIndexToNode(boxInfo, OsMemboxNodeToIndex(boxInfo, node)) != node) {
+            break;
+        }
         PRINT_INFO("(%u,%p)\r\n", index, node);
     }
 
@@ -204,7 +243,7 @@ LITE_OS_SEC_TEXT_MINOR VOID LOS_ShowBox(VOID *pool)
     for (index = 0; index < boxInfo->uwBlkNum; ++index, node = OS_MEMBOX_NEXT(node, boxInfo->uwBlkSize)) {
         PRINT_INFO("(%u,%p,%p)\r\n", index, node, node->pstNext);
     }
-    MEMBOX_UNLOCK(intSave);
+    LOS_IntRestore(intSave);
 }
 
 LITE_OS_SEC_TEXT_MINOR UINT32 LOS_MemboxStatisticsGet(const VOID *boxMem, UINT32 *maxBlk,
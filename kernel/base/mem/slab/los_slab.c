@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_slab_pri.h"
+#include "los_memory.h"
+#include "los_spinlock.h"
+#include "los_hwi.h"
+#include "los_seq_buf.h"
+#include "los_vm_common.h"
+#include "securec.h"
+#ifdef LOSCFG_KERNEL_VM
+#include "los_vm_phys.h"
+#endif
+
+#define OS_SLAB_SIZE            PAGE_SIZE
+#define OS_SLAB_NAME_LEN        16
+#define OS_SLAB_OBJ_ALIGN       (sizeof(UINTPTR) << 1)
+#define OS_SLAB_MIN_OBJ_NUM     4   /* a slab holding fewer objects wastes too much of its page */
+#define OS_SLAB_MAGAZINE_DEPTH  8   /* objects each cpu keeps at hand */
+#define OS_SLAB_MAGAZINE_BATCH  (OS_SLAB_MAGAZINE_DEPTH >> 1)
+#define OS_SLAB_FREE_SLAB_MAX   1   /* empty slabs kept before pages go back */
+#define OS_SLAB_HEAD_SIZE       OS_SLAB_ALIGN(sizeof(SlabHead))
+#define OS_SLAB_ALIGN(size)     (((size) + OS_SLAB_OBJ_ALIGN - 1) & ~(OS_SLAB_OBJ_ALIGN - 1))
+#define OS_SLAB_FROM_OBJ(obj)   ((SlabHead *)((UINTPTR)(obj) & ~((UINTPTR)OS_SLAB_SIZE - 1)))
+
+typedef struct {
+    UINT32 count;
+    VOID *obj[OS_SLAB_MAGAZINE_DEPTH];
+} SlabMagazine;
+
+struct OsSlabCache {
+    CHAR            name[OS_SLAB_NAME_LEN];
+    UINT32          objSize;
+    UINT32          objNum;         /* objects per slab */
+    SlabCtorFunc    ctor;
+    SPIN_LOCK_S     lock;
+    LOS_DL_LIST     partialList;    /* slabs with both used and free objects */
+    LOS_DL_LIST     fullList;       /* slabs without free objects */
+    LOS_DL_LIST     freeList;       /* slabs without used objects */
+    LOS_DL_LIST     cacheList;
+    UINT32          slabNum;
+    UINT32          freeSlabNum;
+    UINT32          freeObjNum;     /* free objects in slabs, not counting the magazines */
+    SlabMagazine    magazine[LOSCFG_KERNEL_CORE_NUM];
+};
+
+/* Lies at the start of the page of every slab */
+typedef struct {
+    LOS_DL_LIST     node;
+    SlabCache       *cache;
+    VOID            *freeObj;       /* free objects, linked through their first word */
+    UINT32          inuse;
+} SlabHead;
+
+LITE_OS_SEC_BSS STATIC LOS_DL_LIST g_slabCacheList = { &g_slabCacheList, &g_slabCacheList };
+LITE_OS_SEC_BSS STATIC SPIN_LOCK_INIT(g_slabSpin);
+
+STATIC VOID *OsSlabPageAlloc(VOID)
+{
+#ifdef LOSCFG_KERNEL_VM
+    return LOS_PhysPagesAllocContiguous(1);
+#else
+    return LOS_MemAllocAlign(m_aucSysMem0, OS_SLAB_SIZE, OS_SLAB_SIZE);
+#endif
+}
+
+STATIC VOID OsSlabPageFree(VOID *page)
+{
+#ifdef LOSCFG_KERNEL_VM
+    LOS_PhysPagesFreeContiguous(page, 1);
+#else
+    (VOID)LOS_MemFree(m_aucSysMem0, page);
+#endif
+}
+
+SlabCache *OsSlabCacheCreate(const CHAR *name, UINT32 objSize, SlabCtorFunc ctor)
+{
+    SlabCache *cache = NULL;
+    UINT32 intSave;
+
+    if ((name == NULL) || (objSize == 0)) {
+        return NULL;
+    }
+
+    objSize = OS_SLAB_ALIGN(objSize);
+    if (((OS_SLAB_SIZE - OS_SLAB_HEAD_SIZE) / objSize) < OS_SLAB_MIN_OBJ_NUM) {
+        PRINT_ERR("%s: object size %u of %s is too large\n", __FUNCTION__, objSize, name);
+        return NULL;
+    }
+
+    cache = (SlabCache *)LOS_MemAlloc(m_aucSysMem0, sizeof(SlabCache));
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    (VOID)memset_s(cache, sizeof(SlabCache), 0, sizeof(SlabCache));
+    (VOID)strncpy_s(cache->name, OS_SLAB_NAME_LEN, name, OS_SLAB_NAME_LEN - 1);
+    cache->objSize = objSize;
+    cache->objNum = (OS_SLAB_SIZE - OS_SLAB_HEAD_SIZE) / objSize;
+    cache->ctor = ctor;
+    LOS_SpinInit(&cache->lock);
+    LOS_ListInit(&cache->partialList);
+    LOS_ListInit(&cache->fullList);
+    LOS_ListInit(&cache->freeList);
+
+    LOS_SpinLockSave(&g_slabSpin, &intSave);
+    LOS_ListTailInsert(&g_slabCacheList, &cache->cacheList);
+    LOS_SpinUnlockRestore(&g_slabSpin, intSave);
+    return cache;
+}
+
+/* Called with the cache lock held */
+STATIC SlabHead *OsSlabGrow(SlabCache *cache)
+{
+    SlabHead *slab = (SlabHead *)OsSlabPageAlloc();
+    UINT32 index;
+    VOID *obj = NULL;
+
+    if (slab == NULL) {
+        return NULL;
+    }
+
+    slab->cache = cache;
+    slab->inuse = 0;
+    slab->freeObj = NULL;
+    for (index = cache->objNum; index > 0; index--) {
+        obj = (VOID *)((UINTPTR)slab + OS_SLAB_HEAD_SIZE + ((index - 1) * cache->objSize));
+        if (cache->ctor != NULL) {
+            cache->ctor(obj);
+        }
+        *(VOID **)obj = slab->freeObj;
+        slab->freeObj = obj;
+    }
+
+    LOS_ListAdd(&cache->partialList, &slab->node);
+    cache->slabNum++;
+    cache->freeObjNum += cache->objNum;
+    return slab;
+}
+
+/* Called with the cache lock held, takes half a magazine of objects out of the slabs */
+STATIC VOID OsSlabMagazineFill(SlabCache *cache, SlabMagazine *magazine)
+{
+    SlabHead *slab = NULL;
+    VOID *obj = NULL;
+
+    while (magazine->count < OS_SLAB_MAGAZINE_BATCH) {
+        if (!LOS_ListEmpty(&cache->partialList)) {
+            slab = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&cache->partialList), SlabHead, node);
+        } else if (!LOS_ListEmpty(&cache->freeList)) {
+            slab = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&cache->freeList), SlabHead, node);
+            LOS_ListDelete(&slab->node);
+            LOS_ListAdd(&cache->partialList, &slab->node);
+            cache->freeSlabNum--;
+        } else {
+            slab = OsSlabGrow(cache);
+            if (slab == NULL) {
+                break;
+            }
+        }
+
+        obj = slab->freeObj;
+        slab->freeObj = *(VOID **)obj;
+        slab->inuse++;
+        cache->freeObjNum--;
+        if (slab->freeObj == NULL) {
+            LOS_ListDelete(&slab->node);
+            LOS_ListAdd(&cache->fullList, &slab->node);
+        }
+        magazine->obj[magazine->count++] = obj;
+    }
+}
+
+/* Called with the cache lock held, gives the older half of a full magazine back to the slabs */
+STATIC VOID OsSlabMagazineDrain(SlabCache *cache, SlabMagazine *magazine)
+{
+    SlabHead *slab = NULL;
+    VOID *obj = NULL;
+    UINT32 index;
+
+    for (index = 0; index < OS_SLAB_MAGAZINE_BATCH; index++) {
+        obj = magazine->obj[index];
+        slab = OS_SLAB_FROM_OBJ(obj);
+        if (slab->freeObj == NULL) {
+            LOS_ListDelete(&slab->node);
+            LOS_ListAdd(&cache->partialList, &slab->node);
+        }
+        *(VOID **)obj = slab->freeObj;
+        slab->freeObj = obj;
+        slab->inuse--;
+        cache->freeObjNum++;
+        if (slab->inuse != 0) {
+            continue;
+        }
+
+        LOS_ListDelete(&slab->node);
+        if (cache->freeSlabNum < OS_SLAB_FREE_SLAB_MAX) {
+            LOS_ListAdd(&cache->freeList, &slab->node);
+            cache->freeSlabNum++;
+        } else {
+            cache->slabNum--;
+            cache->freeObjNum -= cache->objNum;
+            OsSlabPageFree(slab);
+        }
+    }
+
+    magazine->count -= OS_SLAB_MAGAZINE_BATCH;
+    for (index = 0; index < magazine->count; index++) {
+        magazine->obj[index] = magazine->obj[index + OS_SLAB_MAGAZINE_BATCH];
+    }
+}
+
+VOID *OsSlabAlloc(SlabCache *cache)
+{
+    SlabMagazine *magazine = NULL;
+    VOID *obj = NULL;
+    UINT32 intSave;
+
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    /* Interrupts stay off so the magazine of this cpu is not touched by anyone else */
+    intSave = LOS_IntLock();
+    magazine = &cache->magazine[ArchCurrCpuid()];
+    if (magazine->count == 0) {
+        LOS_SpinLock(&cache->lock);
+        OsSlabMagazineFill(cache, magazine);
+        LOS_SpinUnlock(&cache->lock);
+    }
+
+    if (magazine->count != 0) {
+        obj = magazine->obj[--magazine->count];
+    }
+    LOS_IntRestore(intSave);
+
+    return obj;
+}
+
+VOID OsSlabFree(SlabCache *cache, VOID *obj)
+{
+    SlabMagazine *magazine = NULL;
+    UINT32 intSave;
+
+    if ((cache == NULL) || (obj == NULL)) {
+        return;
+    }
+
+    if (OS_SLAB_FROM_OBJ(obj)->cache != cache) {
+        PRINT_ERR("%s: %p does not belong to %s\n", __FUNCTION__, obj, cache->name);
+        return;
+    }
+
+    intSave = LOS_IntLock();
+    magazine = &cache->magazine[ArchCurrCpuid()];
+    if (magazine->count == OS_SLAB_MAGAZINE_DEPTH) {
+        LOS_SpinLock(&cache->lock);
+        OsSlabMagazineDrain(cache, magazine);
+        LOS_SpinUnlock(&cache->lock);
+    }
+    magazine->obj[magazine->count++] = obj;
+    LOS_IntRestore(intSave);
+}
+
+VOID OsSlabInfoShow(struct SeqBuf *seqBuf)
+{
+    SlabCache *cache = NULL;
+    UINT32 cachedNum, totalNum, freeNum, slabNum, cpuid;
+    UINT32 intSave;
+
+    (VOID)LosBufPrintf(seqBuf, "%-16s %-10s %-10s %-10s %-8s %-10s %s\n", "name", "active_objs", "num_objs",
+                       "cpu_cached", "objsize", "objperslab", "slabs");
+    LOS_SpinLockSave(&g_slabSpin, &intSave);
+    LOS_DL_LIST_FOR_EACH_ENTRY(cache, &g_slabCacheList, SlabCache, cacheList) {
+        cachedNum = 0;
+        for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+            cachedNum += cache->magazine[cpuid].count;
+        }
+        LOS_SpinLock(&cache->lock);
+        totalNum = cache->slabNum * cache->objNum;
+        freeNum = cache->freeObjNum;
+        slabNum = cache->slabNum;
+        LOS_SpinUnlock(&cache->lock);
+        (VOID)LosBufPrintf(seqBuf, "%-16s %-11u %-10u %-10u %-8u %-10u %u\n", cache->name,
+                           totalNum - freeNum - cachedNum, totalNum, cachedNum,
+                           cache->objSize, cache->objNum, slabNum);
+    }
+    LOS_SpinUnlockRestore(&g_slabSpin, intSave);
+}
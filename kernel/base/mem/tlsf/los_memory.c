@@ -38,6 +38,9 @@
 #include "los_vm_filemap.h"
 #include "los_task_pri.h"
 #include "los_hook.h"
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+#include "los_memprof_pri.h"
+#endif
 
 /* Used to cut non-essential functions. */
 #define OS_MEM_FREE_BY_TASKID   0
@@ -149,11 +152,33 @@ struct OsMemPoolInfo {
 #endif
 };
 
+#ifdef LOSCFG_KERNEL_MEM_PERCPU_CACHE
+/* Small blocks freed on a cpu are kept per size class and handed out again without the pool lock */
+#define OS_MEM_CACHE_CLASS_SHIFT    4
+#define OS_MEM_CACHE_CLASS_NUM      8   /* 16, 32, ... 128 bytes */
+#define OS_MEM_CACHE_DEPTH          16  /* blocks a magazine holds */
+#define OS_MEM_CACHE_BATCH          (OS_MEM_CACHE_DEPTH >> 1)
+#define OS_MEM_CACHE_CLASS_SIZE(c)  (((c) + 1) << OS_MEM_CACHE_CLASS_SHIFT)
+#define OS_MEM_CACHE_MAX_SIZE       OS_MEM_CACHE_CLASS_SIZE(OS_MEM_CACHE_CLASS_NUM - 1)
+
+struct OsMemCacheMagazine {
+    UINT32 count;
+    struct OsMemNodeHead *node[OS_MEM_CACHE_DEPTH];
+};
+
+struct OsMemCpuCache {
+    struct OsMemCacheMagazine magazine[OS_MEM_CACHE_CLASS_NUM];
+};
+#endif
+
 struct OsMemPoolHead {
     struct OsMemPoolInfo info;
     UINT32 freeListBitmap[OS_MEM_BITMAP_WORDS];
     struct OsMemFreeNodeHead *freeList[OS_MEM_FREE_LIST_COUNT];
     SPIN_LOCK_S spinlock;
+#ifdef LOSCFG_KERNEL_MEM_PERCPU_CACHE
+    struct OsMemCpuCache *cache;    /* one per cpu, NULL if the pool has no cache */
+#endif
 #ifdef LOSCFG_MEM_MUL_POOL
     VOID *nextPool;
 #endif
@@ -169,6 +194,12 @@ struct OsMemPoolHead {
 #define OS_MEM_POOL_LOCK_ENABLE    0x02
 
 #define OS_MEM_NODE_MAGIC        0xABCDDCBA
+#ifdef LOSCFG_KERNEL_MEM_PERCPU_CACHE
+#define OS_MEM_NODE_CACHED_MAGIC 0xABCDCACE  /* Used node parked in a cpu cache, free for accounting */
+#endif
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+#define OS_MEM_NODE_SAMPLED_MAGIC 0xABCD5A3D /* Used node charged to a call stack by the heap profiler */
+#endif
 #define OS_MEM_MIN_ALLOC_SIZE    (sizeof(struct OsMemFreeNodeHead) - sizeof(struct OsMemUsedNodeHead))
 
 #define OS_MEM_NODE_USED_FLAG      0x80000000U
@@ -210,7 +241,18 @@ struct OsMemPoolHead {
 #define OS_MEM_MIDDLE_ADDR(startAddr, middleAddr, endAddr) \
     (((UINT8 *)(startAddr) <= (UINT8 *)(middleAddr)) && ((UINT8 *)(middleAddr) <= (UINT8 *)(endAddr)))
 #define OS_MEM_SET_MAGIC(node)      ((node)->magic = OS_MEM_NODE_MAGIC)
-#define OS_MEM_MAGIC_VALID(node)    ((node)->magic == OS_MEM_NODE_MAGIC)
+#ifdef LOSCFG_KERNEL_MEM_PERCPU_CACHE
+#define OS_MEM_NODE_IS_CACHED(node) ((node)->magic == OS_MEM_NODE_CACHED_MAGIC)
+#else
+#define OS_MEM_NODE_IS_CACHED(node) FALSE
+#endif
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+#define OS_MEM_NODE_IS_SAMPLED(node) ((node)->magic == OS_MEM_NODE_SAMPLED_MAGIC)
+#else
+#define OS_MEM_NODE_IS_SAMPLED(node) FALSE
+#endif
+#define OS_MEM_MAGIC_VALID(node) \
+    (((node)->magic == OS_MEM_NODE_MAGIC) || OS_MEM_NODE_IS_CACHED(node) || OS_MEM_NODE_IS_SAMPLED(node))
 
 STATIC INLINE VOID OsMemFreeNodeAdd(VOID *pool, struct OsMemFreeNodeHead *node);
 STATIC INLINE UINT32 OsMemFree(struct OsMemPoolHead *pool, struct OsMemNodeHead *node);
@@ -451,7 +493,7 @@ STATIC INLINE VOID OsMemUsedNodePrint(struct OsMemNodeHead *node)
 {
     UINT32 count;
 
-    if (OS_MEM_NODE_GET_USED_FLAG(node->sizeAndFlag)) {
+    if (OS_MEM_NODE_GET_USED_FLAG(node->sizeAndFlag) && !OS_MEM_NODE_IS_CACHED(node)) {
 #ifdef __LP64__
         PRINTK("0x%018x: ", node);
 #else
@@ -896,6 +938,26 @@ UINT32 LOS_MemPoolList(VOID)
 }
 #endif
 
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+/* Only the kernel heap is profiled, it is the pool that grows over long uptimes */
+STATIC INLINE VOID OsMemProfNodeSample(const struct OsMemPoolHead *pool, VOID *ptr, UINT32 size)
+{
+    struct OsMemNodeHead *node = (struct OsMemNodeHead *)((UINTPTR)ptr - OS_MEM_NODE_HEAD_SIZE);
+
+    if ((ptr != NULL) && ((VOID *)pool == (VOID *)m_aucSysMem0) && OsMemProfSample(node, size)) {
+        node->magic = OS_MEM_NODE_SAMPLED_MAGIC;
+    }
+}
+
+STATIC INLINE VOID OsMemProfNodeRelease(struct OsMemNodeHead *node)
+{
+    if (OS_MEM_NODE_IS_SAMPLED(node)) {
+        OsMemProfRelease(node);
+        node->magic = OS_MEM_NODE_MAGIC;
+    }
+}
+#endif
+
 STATIC INLINE VOID *OsMemAlloc(struct OsMemPoolHead *pool, UINT32 size, UINT32 intSave)
 {
     struct OsMemNodeHead *allocNode = NULL;
@@ -944,6 +1006,124 @@ retry:
     return OsMemCreateUsedNode((VOID *)allocNode);
 }
 
+#ifdef LOSCFG_KERNEL_MEM_PERCPU_CACHE
+STATIC UINT32 OsMemCacheInit(struct OsMemPoolHead *pool)
+{
+    UINT32 cacheSize = sizeof(struct OsMemCpuCache) * LOSCFG_KERNEL_CORE_NUM;
+    struct OsMemCpuCache *cache = LOS_MemAlloc(pool, cacheSize);
+    if (cache == NULL) {
+        return LOS_NOK;
+    }
+
+    (VOID)memset_s(cache, cacheSize, 0, cacheSize);
+    pool->cache = cache;
+    return LOS_OK;
+}
+
+/* Called with the pool lock held, moves half a magazine of blocks from the pool into it */
+STATIC VOID OsMemCacheRefill(struct OsMemPoolHead *pool, struct OsMemCacheMagazine *magazine,
+                             UINT32 cacheClass, UINT32 intSave)
+{
+    UINT32 allocSize = OS_MEM_ALIGN(OS_MEM_CACHE_CLASS_SIZE(cacheClass) + OS_MEM_NODE_HEAD_SIZE, OS_MEM_ALIGN_SIZE);
+    struct OsMemNodeHead *node = NULL;
+    UINT32 index;
+
+    while (magazine->count < OS_MEM_CACHE_BATCH) {
+        /* Leave the last free blocks to the slow path, which expands the pool and reports failures */
+        if (OsMemFindNextSuitableBlock(pool, allocSize, &index) == NULL) {
+            break;
+        }
+        VOID *ptr = OsMemAlloc(pool, OS_MEM_CACHE_CLASS_SIZE(cacheClass), intSave);
+        if (ptr == NULL) {
+            break;
+        }
+        node = (struct OsMemNodeHead *)((UINTPTR)ptr - OS_MEM_NODE_HEAD_SIZE);
+        node->magic = OS_MEM_NODE_CACHED_MAGIC;
+        magazine->node[magazine->count++] = node;
+    }
+}
+
+/* Called with the pool lock held, gives the older half of a full magazine back to the pool */
+STATIC VOID OsMemCacheDrain(struct OsMemPoolHead *pool, struct OsMemCacheMagazine *magazine)
+{
+    UINT32 index;
+
+    for (index = 0; index < OS_MEM_CACHE_BATCH; index++) {
+        magazine->node[index]->magic = OS_MEM_NODE_MAGIC;
+        (VOID)OsMemFree(pool, magazine->node[index]);
+    }
+
+    magazine->count -= OS_MEM_CACHE_BATCH;
+    for (index = 0; index < magazine->count; index++) {
+        magazine->node[index] = magazine->node[index + OS_MEM_CACHE_BATCH];
+    }
+}
+
+STATIC VOID *OsMemCacheAlloc(struct OsMemPoolHead *pool, UINT32 size)
+{
+    UINT32 cacheClass = (size - 1) >> OS_MEM_CACHE_CLASS_SHIFT;
+    struct OsMemCacheMagazine *magazine = NULL;
+    struct OsMemNodeHead *node = NULL;
+    UINT32 intSave;
+
+    /* Interrupts stay off so the magazine of this cpu is not touched by anyone else */
+    intSave = LOS_IntLock();
+    magazine = &pool->cache[ArchCurrCpuid()].magazine[cacheClass];
+    if (magazine->count == 0) {
+        LOS_SpinLock(&pool->spinlock);
+        OsMemCacheRefill(pool, magazine, cacheClass, intSave);
+        LOS_SpinUnlock(&pool->spinlock);
+    }
+
+    if (magazine->count != 0) {
+        node = magazine->node[--magazine->count];
+        node->magic = OS_MEM_NODE_MAGIC;
+#ifdef LOSCFG_MEM_LEAKCHECK
+        OsMemLinkRegisterRecord(node);
+#endif
+    }
+    LOS_IntRestore(intSave);
+
+    return (node != NULL) ? (VOID *)((UINTPTR)node + OS_MEM_NODE_HEAD_SIZE) : NULL;
+}
+
+STATIC BOOL OsMemCacheFree(struct OsMemPoolHead *pool, struct OsMemNodeHead *node, UINT32 *ret)
+{
+    UINT32 usableSize = OS_MEM_NODE_GET_SIZE(node->sizeAndFlag) - OS_MEM_NODE_HEAD_SIZE;
+    UINT32 cacheClass = (usableSize >> OS_MEM_CACHE_CLASS_SHIFT) - 1;
+    struct OsMemCacheMagazine *magazine = NULL;
+    UINT32 intSave;
+
+    if ((pool->cache == NULL) || OS_MEM_NODE_GET_ALIGNED_FLAG(node->sizeAndFlag) ||
+        (usableSize < OS_MEM_CACHE_CLASS_SIZE(0)) || (cacheClass >= OS_MEM_CACHE_CLASS_NUM)) {
+        return FALSE;
+    }
+
+    if (!OS_MEM_NODE_GET_USED_FLAG(node->sizeAndFlag) || (node->magic != OS_MEM_NODE_MAGIC)) {
+        PRINT_ERR("[%s] node %#x is not in use, magic: %#x\n", __FUNCTION__, node, node->magic);
+        *ret = LOS_NOK;
+        return TRUE;
+    }
+
+    intSave = LOS_IntLock();
+    magazine = &pool->cache[ArchCurrCpuid()].magazine[cacheClass];
+    if (magazine->count == OS_MEM_CACHE_DEPTH) {
+        LOS_SpinLock(&pool->spinlock);
+        OsMemCacheDrain(pool, magazine);
+        LOS_SpinUnlock(&pool->spinlock);
+    }
+#ifdef LOSCFG_MEM_LEAKCHECK
+    OsMemLinkRegisterRecord(node);
+#endif
+    node->magic = OS_MEM_NODE_CACHED_MAGIC;
+    magazine->node[magazine->count++] = node;
+    LOS_IntRestore(intSave);
+
+    *ret = LOS_OK;
+    return TRUE;
+}
+#endif
+
 VOID *LOS_MemAlloc(VOID *pool, UINT32 size)
 {
     if ((pool == NULL) || (size == 0)) {
@@ -962,11 +1142,22 @@ VOID *LOS_MemAlloc(VOID *pool, UINT32 size)
         if (OS_MEM_NODE_GET_USED_FLAG(size) || OS_MEM_NODE_GET_ALIGNED_FLAG(size)) {
             break;
         }
+#ifdef LOSCFG_KERNEL_MEM_PERCPU_CACHE
+        if ((poolHead->cache != NULL) && (size <= OS_MEM_CACHE_MAX_SIZE)) {
+            ptr = OsMemCacheAlloc(poolHead, size);
+            if (ptr != NULL) {
+                break;
+            }
+        }
+#endif
         MEM_LOCK(poolHead, intSave);
         ptr = OsMemAlloc(poolHead, size, intSave);
         MEM_UNLOCK(poolHead, intSave);
     } while (0);
 
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+    OsMemProfNodeSample(poolHead, ptr, size);
+#endif
     OsHookCall(LOS_HOOK_TYPE_MEM_ALLOC, pool, ptr, size);
     return ptr;
 }
@@ -1007,6 +1198,9 @@ VOID *LOS_MemAllocAlign(VOID *pool, UINT32 size, UINT32 boundary)
         MEM_LOCK(poolHead, intSave);
         ptr = OsMemAlloc(pool, useSize, intSave);
         MEM_UNLOCK(poolHead, intSave);
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+        OsMemProfNodeSample(poolHead, ptr, size);
+#endif
         alignedPtr = (VOID *)OS_MEM_ALIGN(ptr, boundary);
         if (ptr == alignedPtr) {
             break;
@@ -1133,6 +1327,9 @@ STATIC INLINE UINT32 OsMemFree(struct OsMemPoolHead *pool, struct OsMemNodeHead
         PRINT_ERR("OsMemFree check error!\n");
         return ret;
     }
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+    OsMemProfNodeRelease(node);
+#endif
 
 #ifdef LOSCFG_MEM_WATERLINE
     pool->info.curUsedSize -= OS_MEM_NODE_GET_SIZE(node->sizeAndFlag);
@@ -1200,6 +1397,14 @@ UINT32 LOS_MemFree(VOID *pool, VOID *ptr)
             }
             node = (struct OsMemNodeHead *)((UINTPTR)ptr - gapSize - OS_MEM_NODE_HEAD_SIZE);
         }
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+        OsMemProfNodeRelease(node);
+#endif
+#ifdef LOSCFG_KERNEL_MEM_PERCPU_CACHE
+        if (OsMemCacheFree(poolHead, node, &ret)) {
+            break;
+        }
+#endif
         MEM_LOCK(poolHead, intSave);
         ret = OsMemFree(poolHead, node);
         MEM_UNLOCK(poolHead, intSave);
@@ -1334,8 +1539,20 @@ VOID *LOS_MemRealloc(VOID *pool, VOID *ptr, UINT32 size)
         }
 
         newPtr = OsMemRealloc(pool, ptr, node, size, intSave);
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+        /*
+         * The profiler sees a reallocation as a free of the old block and a new allocation. A moved block
+         * was released by OsMemFree, one resized in place still carries the charge, a failed one keeps it.
+         */
+        if (newPtr == ptr) {
+            OsMemProfNodeRelease(node);
+        }
+#endif
     } while (0);
     MEM_UNLOCK(poolHead, intSave);
+#ifdef LOSCFG_KERNEL_MEM_PROFILE
+    OsMemProfNodeSample(poolHead, newPtr, size);
+#endif
 
     return newPtr;
 }
@@ -1443,7 +1660,7 @@ UINT32 LOS_MemTotalUsedGet(VOID *pool)
                 break;
             }
         } else {
-            if (OS_MEM_NODE_GET_USED_FLAG(tmpNode->sizeAndFlag)) {
+            if (OS_MEM_NODE_GET_USED_FLAG(tmpNode->sizeAndFlag) && !OS_MEM_NODE_IS_CACHED(tmpNode)) {
                 memUsed += OS_MEM_NODE_GET_SIZE(tmpNode->sizeAndFlag);
             }
             tmpNode = OS_MEM_NEXT_NODE(tmpNode);
@@ -1451,7 +1668,7 @@ UINT32 LOS_MemTotalUsedGet(VOID *pool)
     }
 #else
     for (tmpNode = OS_MEM_FIRST_NODE(pool); tmpNode < endNode;) {
-        if (OS_MEM_NODE_GET_USED_FLAG(tmpNode->sizeAndFlag)) {
+        if (OS_MEM_NODE_GET_USED_FLAG(tmpNode->sizeAndFlag) && !OS_MEM_NODE_IS_CACHED(tmpNode)) {
             memUsed += OS_MEM_NODE_GET_SIZE(tmpNode->sizeAndFlag);
         }
         tmpNode = OS_MEM_NEXT_NODE(tmpNode);
@@ -1723,7 +1940,7 @@ STATIC INLINE VOID OsMemInfoGet(struct OsMemPoolHead *poolInfo, struct OsMemNode
     UINT32 maxFreeSize = 0;
     UINT32 size;
 
-    if (!OS_MEM_NODE_GET_USED_FLAG(node->sizeAndFlag)) {
+    if (!OS_MEM_NODE_GET_USED_FLAG(node->sizeAndFlag) || OS_MEM_NODE_IS_CACHED(node)) {
         size = OS_MEM_NODE_GET_SIZE(node->sizeAndFlag);
         ++freeNodeNum;
         totalFreeSize += size;
@@ -1898,6 +2115,11 @@ STATUS_T OsKHeapInit(size_t size)
     }
 #if OS_MEM_EXPAND_ENABLE
     LOS_MemExpandEnable(OS_SYS_MEM_ADDR);
+#endif
+#ifdef LOSCFG_KERNEL_MEM_PERCPU_CACHE
+    if (OsMemCacheInit((struct OsMemPoolHead *)m_aucSysMem0) != LOS_OK) {
+        PRINT_ERR("vmm_kheap_init cpu cache init failed!\n");
+    }
 #endif
     return LOS_OK;
 }
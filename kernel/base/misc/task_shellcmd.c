@@ -119,6 +119,8 @@ LITE_OS_SEC_TEXT_MINOR UINT8 *OsShellCmdSchedPolicy(UINT16 policy)
         return (UINT8 *)"RR";
     } else if (policy == LOS_SCHED_FIFO) {
         return (UINT8 *)"FIFO";
+    } else if (policy == LOS_SCHED_DEADLINE) {
+        return (UINT8 *)"DL";
     } else if (policy == LOS_SCHED_IDLE) {
         return (UINT8 *)"IDLE";
     }
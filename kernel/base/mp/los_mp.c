@@ -30,6 +30,7 @@
  */
 
 #include "los_mp.h"
+#include "los_atomic.h"
 #include "los_init.h"
 #include "los_percpu_pri.h"
 #include "los_sched_pri.h"
@@ -38,11 +39,39 @@
 
 #ifdef LOSCFG_KERNEL_SMP
 
+/* Set while a schedule ipi to the cpu is in flight, further requests are merged into it */
+STATIC Atomic g_mpSchedPending[LOSCFG_KERNEL_CORE_NUM];
+
 VOID LOS_MpSchedule(UINT32 target)
 {
+    UINT32 intSave = LOS_IntLock();
     UINT32 cpuid = ArchCurrCpuid();
-    target &= ~(1U << cpuid);
-    HalIrqSendIpi(target, LOS_MP_IPI_SCHEDULE);
+    UINT32 index;
+
+    /*
+     * A broadcast is a request after a wakeup, only the cpus whose running task is
+     * preempted by the woken tasks are interrupted.
+     */
+    if (target == OS_MP_CPU_ALL) {
+        target = OsSchedPreemptMaskGet();
+    }
+
+    if (target & (1U << cpuid)) {
+        /* never drop a request for this cpu, it reschedules at the next preemption point */
+        OsPercpuGet()->schedFlag |= INT_PEND_RESCH;
+        target &= ~(1U << cpuid);
+    }
+    LOS_IntRestore(intSave);
+
+    for (index = 0; index < LOSCFG_KERNEL_CORE_NUM; index++) {
+        if ((target & CPUID_TO_AFFI_MASK(index)) && LOS_AtomicCmpXchg32bits(&g_mpSchedPending[index], 1, 0)) {
+            target &= ~CPUID_TO_AFFI_MASK(index);
+        }
+    }
+
+    if (target != 0) {
+        HalIrqSendIpi(target, LOS_MP_IPI_SCHEDULE);
+    }
 }
 
 VOID OsMpWakeHandler(VOID)
@@ -52,6 +81,8 @@ VOID OsMpWakeHandler(VOID)
 
 VOID OsMpScheduleHandler(VOID)
 {
+    LOS_AtomicSet(&g_mpSchedPending[ArchCurrCpuid()], 0);
+
     /*
      * set schedule flag to differ from wake function,
      * so that the scheduler can be triggered at the end of irq.
@@ -44,6 +44,7 @@
 #include "los_stackinfo_pri.h"
 #endif
 #include "los_mp.h"
+#include "los_atomic.h"
 #ifdef LOSCFG_SCHED_DEBUG
 #include "los_stat_pri.h"
 #endif
@@ -58,17 +59,58 @@
 #define OS_SCHED_READY_MAX         30
 #define OS_TIME_SLICE_MIN          (INT32)((50 * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE) /* 50us */
 
+/* A task that ran within this time is assumed to still have a warm cache on its last cpu */
+#define OS_SCHED_MIGRATION_COST    ((500 * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE) /* 500us */
+/* Extra load difference needed before a cache hot task is moved off its last cpu */
+#define OS_SCHED_HOT_IMBALANCE     2
+
+/* Deadline task bandwidth is runtime / period in fixed point, a whole cpu is (1 << OS_SCHED_DL_BW_SHIFT) */
+#define OS_SCHED_DL_BW_SHIFT       20
+#define OS_SCHED_DL_BW_LIMIT       ((95ULL << OS_SCHED_DL_BW_SHIFT) / 100) /* 95% of each cpu */
+
+/* Process and task priority folded into one key, a smaller key means a higher priority */
+#define OS_SCHED_PRIORITY_KEY(proPriority, priority) (((proPriority) * OS_PRIORITY_QUEUE_NUM) + (priority))
+#define OS_SCHED_PRIORITY_KEY_MAX                    (OS_PRIORITY_QUEUE_NUM * OS_PRIORITY_QUEUE_NUM)
+#define OS_SCHED_KEY_PROCESS_PRIORITY(key)           ((key) / OS_PRIORITY_QUEUE_NUM)
+#define OS_SCHED_KEY_PRIORITY(key)                   ((key) % OS_PRIORITY_QUEUE_NUM)
+
 typedef struct {
     LOS_DL_LIST priQueueList[OS_PRIORITY_QUEUE_NUM];
     UINT32      readyTasks[OS_PRIORITY_QUEUE_NUM];
     UINT32      queueBitmap;
 } SchedQueue;
 
+#ifdef LOSCFG_KERNEL_SMP
+typedef struct {
+    LOS_DL_LIST priQueueList[OS_PRIORITY_QUEUE_NUM];
+    UINT32      queueBitmap;
+} SchedStealQueue;
+#endif
+
 typedef struct {
     SchedQueue queueList[OS_PRIORITY_QUEUE_NUM];
     UINT32     queueBitmap;
-    SchedScan  taskScan;
-    SchedScan  swtmrScan;
+#ifdef LOSCFG_KERNEL_SMP
+    SchedStealQueue stealQueue[OS_PRIORITY_QUEUE_NUM]; /* The ready tasks other cpus are allowed to run */
+    UINT32          stealBitmap;
+#endif
+    LOS_DL_LIST dlQueue;        /* Ready deadline tasks, sorted by absolute deadline */
+    UINT32     readyTaskNum;    /* The number of ready tasks on this run queue */
+    LosTaskCB  *runTask;        /* The task currently running on the cpu owning this run queue */
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+    UINT64     runStartTime;    /* The time runTask got the cpu */
+    UINT64     preemptTime;     /* The time runTask was first found preempted, 0 if it was not */
+#endif
+} SchedRunqueue;
+
+typedef struct {
+    SchedRunqueue runqueue[LOSCFG_KERNEL_CORE_NUM];
+    UINT64        dlTotalBw;    /* Bandwidth reserved by all deadline tasks */
+#ifdef LOSCFG_KERNEL_SMP
+    Atomic        preemptMask[LOSCFG_KERNEL_CORE_NUM]; /* Per waking cpu, cpus whose running task it preempted */
+#endif
+    SchedScan     taskScan;
+    SchedScan     swtmrScan;
 } Sched;
 
 STATIC Sched *g_sched = NULL;
@@ -258,6 +300,50 @@ STATIC VOID OsSchedSetStartTime(UINT64 currCycle)
     }
 }
 
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+/* Only fixed priority tasks of user processes are limited by the quota of their process group */
+STATIC INLINE SchedBandwidth *OsSchedTaskBandwidth(const LosTaskCB *taskCB)
+{
+    const LosProcessCB *processCB = OS_PCB_FROM_PID(taskCB->processID);
+
+    if (((taskCB->policy != LOS_SCHED_RR) && (taskCB->policy != LOS_SCHED_FIFO)) ||
+        !OsProcessIsUserMode(processCB) || (processCB->group == NULL) ||
+        (processCB->group->bandwidth.quota == 0)) {
+        return NULL;
+    }
+
+    return &processCB->group->bandwidth;
+}
+
+STATIC INLINE VOID OsSchedBandwidthCharge(const LosTaskCB *taskCB, INT32 incTime)
+{
+    SchedBandwidth *bandwidth = OsSchedTaskBandwidth(taskCB);
+    if (bandwidth != NULL) {
+        (VOID)LOS_Atomic64Add(&bandwidth->runtime, incTime);
+    }
+}
+
+STATIC INLINE BOOL OsSchedBandwidthExhausted(const LosTaskCB *taskCB)
+{
+    const SchedBandwidth *bandwidth = OsSchedTaskBandwidth(taskCB);
+
+    return (bandwidth != NULL) && ((UINT64)LOS_Atomic64Read(&bandwidth->runtime) >= bandwidth->quota);
+}
+
+/* The tick must come back no later than the moment the group uses up its quota */
+STATIC INLINE UINT64 OsSchedBandwidthEndTime(const LosTaskCB *taskCB, UINT64 startTime, UINT64 endTime)
+{
+    const SchedBandwidth *bandwidth = OsSchedTaskBandwidth(taskCB);
+    if (bandwidth == NULL) {
+        return endTime;
+    }
+
+    UINT64 runtime = (UINT64)LOS_Atomic64Read(&bandwidth->runtime);
+    UINT64 quotaEndTime = startTime + ((runtime < bandwidth->quota) ? (bandwidth->quota - runtime) : 0);
+    return (quotaEndTime < endTime) ? quotaEndTime : endTime;
+}
+#endif
+
 STATIC INLINE VOID OsTimeSliceUpdate(LosTaskCB *taskCB, UINT64 currTime)
 {
     LOS_ASSERT(currTime >= taskCB->startTime);
@@ -266,12 +352,15 @@ STATIC INLINE VOID OsTimeSliceUpdate(LosTaskCB *taskCB, UINT64 currTime)
 
     LOS_ASSERT(incTime >= 0);
 
-    if (taskCB->policy == LOS_SCHED_RR) {
+    if ((taskCB->policy == LOS_SCHED_RR) || (taskCB->policy == LOS_SCHED_DEADLINE)) {
         taskCB->timeSlice -= incTime;
 #ifdef LOSCFG_SCHED_DEBUG
         taskCB->schedStat.timeSliceRealTime += incTime;
 #endif
     }
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+    OsSchedBandwidthCharge(taskCB, incTime);
+#endif
     taskCB->irqUsedTime = 0;
     taskCB->startTime = currTime;
 
@@ -374,18 +463,42 @@ VOID OsSchedUpdateExpireTime(UINT64 startTime)
         INT32 timeSlice = (runTask->timeSlice <= OS_TIME_SLICE_MIN) ? runTask->initTimeSlice : runTask->timeSlice;
         LOS_SpinUnlock(&g_taskSpin);
         endTime = startTime + timeSlice;
+    } else if (runTask->policy == LOS_SCHED_DEADLINE) {
+        /* The runtime budget is never refilled while the task is running */
+        LOS_SpinLock(&g_taskSpin);
+        INT32 timeSlice = (runTask->timeSlice > 0) ? runTask->timeSlice : 0;
+        LOS_SpinUnlock(&g_taskSpin);
+        endTime = startTime + timeSlice;
     } else {
         endTime = OS_SCHED_MAX_RESPONSE_TIME - OS_TICK_RESPONSE_PRECISION;
     }
 
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+    endTime = OsSchedBandwidthEndTime(runTask, startTime, endTime);
+#endif
     OsSchedSetNextExpireTime(startTime, runTask->taskID, endTime, runTask->taskID);
 }
 
-STATIC INLINE UINT32 OsSchedCalculateTimeSlice(UINT16 proPriority, UINT16 priority)
+STATIC INLINE SchedRunqueue *OsSchedRunqueueByID(UINT16 cpuid)
+{
+    return &g_sched->runqueue[cpuid];
+}
+
+STATIC INLINE SchedRunqueue *OsSchedTaskRunqueue(const LosTaskCB *taskCB)
+{
+#ifdef LOSCFG_KERNEL_SMP
+    return &g_sched->runqueue[taskCB->rqCpu];
+#else
+    (VOID)taskCB;
+    return &g_sched->runqueue[0];
+#endif
+}
+
+STATIC INLINE UINT32 OsSchedCalculateTimeSlice(const SchedRunqueue *rq, UINT16 proPriority, UINT16 priority)
 {
     UINT32 ratTime, readTasks;
 
-    SchedQueue *queueList = &g_sched->queueList[proPriority];
+    const SchedQueue *queueList = &rq->queueList[proPriority];
     readTasks = queueList->readyTasks[priority];
     if (readTasks > OS_SCHED_READY_MAX) {
         return OS_SCHED_TIME_SLICES_MIN;
@@ -394,9 +507,10 @@ STATIC INLINE UINT32 OsSchedCalculateTimeSlice(UINT16 proPriority, UINT16 priori
     return (ratTime + OS_SCHED_TIME_SLICES_MIN);
 }
 
-STATIC INLINE VOID OsSchedPriQueueEnHead(UINT32 proPriority, LOS_DL_LIST *priqueueItem, UINT32 priority)
+STATIC INLINE VOID OsSchedPriQueueEnHead(SchedRunqueue *rq, UINT32 proPriority, LOS_DL_LIST *priqueueItem,
+                                         UINT32 priority)
 {
-    SchedQueue *queueList = &g_sched->queueList[proPriority];
+    SchedQueue *queueList = &rq->queueList[proPriority];
     LOS_DL_LIST *priQueueList = &queueList->priQueueList[0];
     UINT32 *bitMap = &queueList->queueBitmap;
 
@@ -408,7 +522,7 @@ STATIC INLINE VOID OsSchedPriQueueEnHead(UINT32 proPriority, LOS_DL_LIST *prique
     LOS_ASSERT(priqueueItem->pstNext == NULL);
 
     if (*bitMap == 0) {
-        g_sched->queueBitmap |= PRIQUEUE_PRIOR0_BIT >> proPriority;
+        rq->queueBitmap |= PRIQUEUE_PRIOR0_BIT >> proPriority;
     }
 
     if (LOS_ListEmpty(&priQueueList[priority])) {
@@ -417,11 +531,13 @@ STATIC INLINE VOID OsSchedPriQueueEnHead(UINT32 proPriority, LOS_DL_LIST *prique
 
     LOS_ListHeadInsert(&priQueueList[priority], priqueueItem);
     queueList->readyTasks[priority]++;
+    rq->readyTaskNum++;
 }
 
-STATIC INLINE VOID OsSchedPriQueueEnTail(UINT32 proPriority, LOS_DL_LIST *priqueueItem, UINT32 priority)
+STATIC INLINE VOID OsSchedPriQueueEnTail(SchedRunqueue *rq, UINT32 proPriority, LOS_DL_LIST *priqueueItem,
+                                         UINT32 priority)
 {
-    SchedQueue *queueList = &g_sched->queueList[proPriority];
+    SchedQueue *queueList = &rq->queueList[proPriority];
     LOS_DL_LIST *priQueueList = &queueList->priQueueList[0];
     UINT32 *bitMap = &queueList->queueBitmap;
 
@@ -433,7 +549,7 @@ STATIC INLINE VOID OsSchedPriQueueEnTail(UINT32 proPriority, LOS_DL_LIST *prique
     LOS_ASSERT(priqueueItem->pstNext == NULL);
 
     if (*bitMap == 0) {
-        g_sched->queueBitmap |= PRIQUEUE_PRIOR0_BIT >> proPriority;
+        rq->queueBitmap |= PRIQUEUE_PRIOR0_BIT >> proPriority;
     }
 
     if (LOS_ListEmpty(&priQueueList[priority])) {
@@ -442,23 +558,421 @@ STATIC INLINE VOID OsSchedPriQueueEnTail(UINT32 proPriority, LOS_DL_LIST *prique
 
     LOS_ListTailInsert(&priQueueList[priority], priqueueItem);
     queueList->readyTasks[priority]++;
+    rq->readyTaskNum++;
 }
 
-STATIC INLINE VOID OsSchedPriQueueDelete(UINT32 proPriority, LOS_DL_LIST *priqueueItem, UINT32 priority)
+STATIC INLINE VOID OsSchedPriQueueDelete(SchedRunqueue *rq, UINT32 proPriority, LOS_DL_LIST *priqueueItem,
+                                         UINT32 priority)
 {
-    SchedQueue *queueList = &g_sched->queueList[proPriority];
+    SchedQueue *queueList = &rq->queueList[proPriority];
     LOS_DL_LIST *priQueueList = &queueList->priQueueList[0];
     UINT32 *bitMap = &queueList->queueBitmap;
 
     LOS_ListDelete(priqueueItem);
     queueList->readyTasks[priority]--;
+    rq->readyTaskNum--;
     if (LOS_ListEmpty(&priQueueList[priority])) {
         *bitMap &= ~(PRIQUEUE_PRIOR0_BIT >> priority);
     }
 
     if (*bitMap == 0) {
-        g_sched->queueBitmap &= ~(PRIQUEUE_PRIOR0_BIT >> proPriority);
+        rq->queueBitmap &= ~(PRIQUEUE_PRIOR0_BIT >> proPriority);
+    }
+}
+
+#ifdef LOSCFG_KERNEL_SMP
+/*
+ * Tasks that may run on another cpu are also linked on the steal queue of their run
+ * queue, so a cpu looking for work elsewhere never walks past tasks pinned to the
+ * owner of the run queue.
+ */
+STATIC INLINE VOID OsSchedStealQueueAdd(SchedRunqueue *rq, UINT32 proPriority, LosTaskCB *taskCB)
+{
+    SchedStealQueue *queue = &rq->stealQueue[proPriority];
+
+    if (!(taskCB->cpuAffiMask & ~CPUID_TO_AFFI_MASK(taskCB->rqCpu) & LOSCFG_KERNEL_CPU_MASK)) {
+        return;
+    }
+
+    if (queue->queueBitmap == 0) {
+        rq->stealBitmap |= PRIQUEUE_PRIOR0_BIT >> proPriority;
+    }
+
+    if (LOS_ListEmpty(&queue->priQueueList[taskCB->priority])) {
+        queue->queueBitmap |= PRIQUEUE_PRIOR0_BIT >> taskCB->priority;
+    }
+
+    LOS_ListTailInsert(&queue->priQueueList[taskCB->priority], &taskCB->stealList);
+}
+
+STATIC INLINE VOID OsSchedStealQueueDelete(SchedRunqueue *rq, UINT32 proPriority, LosTaskCB *taskCB)
+{
+    SchedStealQueue *queue = &rq->stealQueue[proPriority];
+
+    /* Pinned tasks are never linked */
+    if (taskCB->stealList.pstNext == NULL) {
+        return;
+    }
+
+    LOS_ListDelete(&taskCB->stealList);
+    if (LOS_ListEmpty(&queue->priQueueList[taskCB->priority])) {
+        queue->queueBitmap &= ~(PRIQUEUE_PRIOR0_BIT >> taskCB->priority);
+    }
+
+    if (queue->queueBitmap == 0) {
+        rq->stealBitmap &= ~(PRIQUEUE_PRIOR0_BIT >> proPriority);
+    }
+}
+#endif
+
+STATIC INLINE UINT64 OsSchedDeadlineBandwidth(UINT32 runtime, UINT32 period)
+{
+    return ((UINT64)runtime << OS_SCHED_DL_BW_SHIFT) / period;
+}
+
+STATIC INLINE VOID OsSchedDeadlineEnQueue(SchedRunqueue *rq, LosTaskCB *taskCB)
+{
+    LOS_DL_LIST *pos = &rq->dlQueue;
+    LosTaskCB *readyTask = NULL;
+
+    LOS_ASSERT(taskCB->pendList.pstNext == NULL);
+
+    /* Tasks with the same deadline keep their arrival order */
+    LOS_DL_LIST_FOR_EACH_ENTRY(readyTask, &rq->dlQueue, LosTaskCB, pendList) {
+        if (readyTask->dlAbsDeadline > taskCB->dlAbsDeadline) {
+            pos = &readyTask->pendList;
+            break;
+        }
+    }
+
+    LOS_ListTailInsert(pos, &taskCB->pendList);
+    rq->readyTaskNum++;
+}
+
+STATIC INLINE VOID OsSchedDeadlineDeQueue(SchedRunqueue *rq, LosTaskCB *taskCB)
+{
+    LOS_ListDelete(&taskCB->pendList);
+    rq->readyTaskNum--;
+}
+
+/*
+ * Constant bandwidth server replenishment. A running task keeps its deadline until
+ * the runtime is used up or the deadline is missed. A waking task also starts a new
+ * period if the runtime left would exceed its bandwidth before the old deadline.
+ */
+STATIC INLINE VOID OsSchedDeadlineReplenish(LosTaskCB *taskCB, UINT64 currTime)
+{
+    if ((taskCB->timeSlice > OS_TIME_SLICE_MIN) && (currTime < taskCB->dlAbsDeadline)) {
+        if (taskCB->taskStatus & OS_TASK_STATUS_RUNNING) {
+            return;
+        }
+
+        UINT64 laxity = taskCB->dlAbsDeadline - currTime;
+        if (((UINT64)(UINT32)taskCB->timeSlice * taskCB->dlPeriod) <= (laxity * taskCB->dlRuntime)) {
+            return;
+        }
+    }
+
+    taskCB->dlAbsDeadline = currTime + taskCB->dlDeadline;
+    taskCB->initTimeSlice = taskCB->dlRuntime;
+    taskCB->timeSlice = (INT32)taskCB->initTimeSlice;
+#ifdef LOSCFG_SCHED_DEBUG
+    taskCB->schedStat.timeSliceTime = taskCB->schedStat.timeSliceRealTime;
+    taskCB->schedStat.timeSliceCount++;
+#endif
+}
+
+/* The task sleeps on the task sortlink until wakeTime instead of waiting on a run queue */
+STATIC VOID OsSchedTaskThrottle(LosTaskCB *taskCB, UINT64 currTime, UINT64 wakeTime)
+{
+    taskCB->waitTimes = (UINT32)((wakeTime - currTime + OS_CYCLE_PER_TICK - 1) / OS_CYCLE_PER_TICK);
+    if (taskCB->taskStatus & OS_TASK_STATUS_RUNNING) {
+        /* The sortlink node is added when the task is switched out */
+        OsSchedTaskDeQueue(taskCB);
+        taskCB->taskStatus |= OS_TASK_STATUS_DELAY;
+    } else {
+        taskCB->taskStatus |= OS_TASK_STATUS_DELAY;
+        OsAdd2SortLink(&taskCB->sortList, currTime, taskCB->waitTimes, OS_SORT_LINK_TASK);
+    }
+}
+
+/*
+ * A deadline task that has used up its runtime is not put back on the run queue but
+ * sleeps until its next period starts, so it never takes more than its reserved bandwidth.
+ */
+STATIC BOOL OsSchedDeadlineThrottle(LosTaskCB *taskCB, UINT64 currTime)
+{
+    UINT64 nextPeriod = taskCB->dlAbsDeadline + (taskCB->dlPeriod - taskCB->dlDeadline);
+
+    if ((taskCB->timeSlice > OS_TIME_SLICE_MIN) || (currTime >= nextPeriod)) {
+        return FALSE;
+    }
+
+    OsSchedTaskThrottle(taskCB, currTime, nextPeriod);
+    return TRUE;
+}
+
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+STATIC INLINE VOID OsSchedBandwidthRefresh(SchedBandwidth *bandwidth, UINT64 currTime)
+{
+    UINT64 elapsed = currTime - bandwidth->periodStart;
+
+    if (elapsed >= bandwidth->period) {
+        bandwidth->periodStart = currTime - (elapsed % bandwidth->period);
+        LOS_Atomic64Set(&bandwidth->runtime, 0);
+    }
+}
+
+/* Tasks of a process group that has used up its quota sleep until the next period starts */
+STATIC BOOL OsSchedBandwidthThrottle(LosTaskCB *taskCB, UINT64 currTime)
+{
+    SchedBandwidth *bandwidth = OsSchedTaskBandwidth(taskCB);
+    if (bandwidth == NULL) {
+        return FALSE;
+    }
+
+    OsSchedBandwidthRefresh(bandwidth, currTime);
+    if ((UINT64)LOS_Atomic64Read(&bandwidth->runtime) < bandwidth->quota) {
+        return FALSE;
+    }
+
+    bandwidth->throttleCount++;
+    OsSchedTaskThrottle(taskCB, currTime, bandwidth->periodStart + bandwidth->period);
+    return TRUE;
+}
+#endif
+
+STATIC INLINE UINT32 OsSchedTaskKey(const LosTaskCB *taskCB)
+{
+    return OS_SCHED_PRIORITY_KEY(OS_PCB_FROM_PID(taskCB->processID)->priority, taskCB->priority);
+}
+
+STATIC INLINE BOOL OsSchedTaskPreempt(const LosTaskCB *taskCB, const LosTaskCB *runTask)
+{
+    if ((runTask == NULL) || (runTask->policy == LOS_SCHED_IDLE)) {
+        return TRUE;
+    }
+
+    if (taskCB->policy == LOS_SCHED_DEADLINE) {
+        return (runTask->policy != LOS_SCHED_DEADLINE) || (taskCB->dlAbsDeadline < runTask->dlAbsDeadline);
+    }
+
+    if (runTask->policy == LOS_SCHED_DEADLINE) {
+        return FALSE;
+    }
+
+    return (OsSchedTaskKey(taskCB) < OsSchedTaskKey(runTask));
+}
+
+#ifdef LOSCFG_KERNEL_SMP
+STATIC INLINE UINT32 OsSchedRunqueueLoad(const SchedRunqueue *rq)
+{
+    UINT32 load = rq->readyTaskNum;
+
+    if ((rq->runTask != NULL) && (rq->runTask->policy != LOS_SCHED_IDLE)) {
+        load++;
+    }
+
+    return load;
+}
+
+STATIC INLINE BOOL OsSchedTaskCacheHot(const LosTaskCB *taskCB)
+{
+    return ((OsGetCurrSchedTimeCycle() - taskCB->lastRunTime) < OS_SCHED_MIGRATION_COST);
+}
+
+/*
+ * Pick the run queue a ready task is placed on. A task that is preempted or yields
+ * stays on the cpu it is running on. A woken task takes an idle cpu at once, trying
+ * the cpu it last ran on and then the cpu of its waker before any other. Otherwise it
+ * stays on its last cpu unless another cpu is less loaded by more than the cost of
+ * losing a warm cache, which is higher if the task ran there only recently.
+ */
+STATIC UINT16 OsSchedSelectRunqueue(const LosTaskCB *taskCB)
+{
+    UINT16 cpuid;
+    UINT16 target = OS_TASK_INVALID_CPUID;
+    UINT32 minLoad = OS_32BIT_MAX;
+    UINT16 prevCpu = taskCB->lastCpu;
+    UINT16 wakerCpu = ArchCurrCpuid();
+    UINT32 prevLoad = OS_32BIT_MAX;
+
+    if ((taskCB->taskStatus & OS_TASK_STATUS_RUNNING) &&
+        (taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(taskCB->currCpu))) {
+        return taskCB->currCpu;
+    }
+
+    if ((prevCpu < LOSCFG_KERNEL_CORE_NUM) && (taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(prevCpu))) {
+        prevLoad = OsSchedRunqueueLoad(OsSchedRunqueueByID(prevCpu));
+        if (prevLoad == 0) {
+            return prevCpu;
+        }
+        target = prevCpu;
+        minLoad = prevLoad;
+    }
+
+    /* The waker is still running on its cpu, so that cpu is idle once the waker blocks */
+    if ((wakerCpu != prevCpu) && (taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(wakerCpu))) {
+        UINT32 load = OsSchedRunqueueLoad(OsSchedRunqueueByID(wakerCpu));
+        if (load < minLoad) {
+            minLoad = load;
+            target = wakerCpu;
+        }
+    }
+
+    for (cpuid = 0; (cpuid < LOSCFG_KERNEL_CORE_NUM) && (minLoad != 0); cpuid++) {
+        if (!(taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid))) {
+            continue;
+        }
+
+        UINT32 load = OsSchedRunqueueLoad(OsSchedRunqueueByID(cpuid));
+        if (load < minLoad) {
+            minLoad = load;
+            target = cpuid;
+        }
+    }
+
+    if (target == OS_TASK_INVALID_CPUID) {
+        return wakerCpu;
+    }
+
+    if ((target != prevCpu) && (minLoad != 0) && (prevLoad != OS_32BIT_MAX)) {
+        UINT32 imbalance = OsSchedTaskCacheHot(taskCB) ? OS_SCHED_HOT_IMBALANCE : 1;
+        if (prevLoad < (minLoad + imbalance)) {
+            return prevCpu;
+        }
+    }
+
+    return target;
+}
+
+STATIC INLINE VOID OsSchedPreemptMark(UINT16 cpuid)
+{
+    INT32 mask;
+    UINT32 currCpu = ArchCurrCpuid();
+
+    if (cpuid == currCpu) {
+        /* The current cpu reschedules on its own when the caller calls LOS_Schedule */
+        return;
+    }
+
+    /* Kept per waking cpu, so that only its own LOS_MpSchedule consumes the request */
+    do {
+        mask = LOS_AtomicRead(&g_sched->preemptMask[currCpu]);
+    } while (LOS_AtomicCmpXchg32bits(&g_sched->preemptMask[currCpu],
+                                     mask | (INT32)CPUID_TO_AFFI_MASK(cpuid), mask));
+}
+
+/*
+ * Record the cpu that has to reschedule for a task just made ready, so that the
+ * following LOS_MpSchedule interrupts that cpu only. A deadline task can be picked
+ * by any cpu, so the first allowed cpu whose running task it preempts is chosen.
+ */
+STATIC VOID OsSchedPreemptCheck(const LosTaskCB *taskCB)
+{
+    if (OsSchedTaskPreempt(taskCB, OsSchedRunqueueByID(taskCB->rqCpu)->runTask)) {
+        OsSchedPreemptMark(taskCB->rqCpu);
+        return;
+    }
+
+    if (taskCB->policy != LOS_SCHED_DEADLINE) {
+        return;
+    }
+
+    for (UINT16 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        if ((taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid)) &&
+            OsSchedTaskPreempt(taskCB, OsSchedRunqueueByID(cpuid)->runTask)) {
+            OsSchedPreemptMark(cpuid);
+            return;
+        }
+    }
+}
+
+UINT32 OsSchedPreemptMaskGet(VOID)
+{
+    return (UINT32)LOS_AtomicXchg32bits(&g_sched->preemptMask[ArchCurrCpuid()], 0);
+}
+#endif
+
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+STATIC INLINE VOID OsSchedLatencyPreemptRequest(SchedRunqueue *rq, const LosTaskCB *taskCB)
+{
+    if ((rq->preemptTime == 0) && OsSchedTaskPreempt(taskCB, rq->runTask)) {
+        rq->preemptTime = OsGetCurrSchedTimeCycle();
+    }
+}
+
+STATIC INLINE VOID OsSchedLatencySwitch(SchedRunqueue *rq, const LosTaskCB *runTask, LosTaskCB *newTask,
+                                        UINT64 currTime)
+{
+    if (runTask->policy != LOS_SCHED_IDLE) {
+        OsSchedLatencyRecord(OS_SCHED_LAT_TIMESLICE, runTask->priority, currTime - rq->runStartTime);
+    }
+
+    if ((newTask->wakeTime != 0) && (newTask->policy != LOS_SCHED_IDLE)) {
+        OsSchedLatencyRecord(OS_SCHED_LAT_WAKEUP, newTask->priority, currTime - newTask->wakeTime);
+    }
+    newTask->wakeTime = 0;
+
+    if (rq->preemptTime != 0) {
+        OsSchedLatencyRecord(OS_SCHED_LAT_PREEMPT, newTask->priority, currTime - rq->preemptTime);
+        rq->preemptTime = 0;
+    }
+
+    rq->runStartTime = currTime;
+}
+#endif
+
+/*
+ * Waiters of a lock pend list are kept in priority order and, within a priority, in FIFO
+ * order. The first waiter of each priority records the last one and the other way round,
+ * so finding the insertion point skips whole priorities instead of single waiters.
+ */
+STATIC INLINE BOOL OsSchedPendSamePriority(const LosTaskCB *taskCB, const LOS_DL_LIST *node)
+{
+    return (node != taskCB->pendHead) && (OS_TCB_FROM_PENDLIST(node)->priority == taskCB->priority);
+}
+
+/* Called after the task has been linked into its lock pend list */
+STATIC INLINE VOID OsSchedPendGroupAdd(LosTaskCB *taskCB)
+{
+    LOS_DL_LIST *prev = taskCB->pendList.pstPrev;
+
+    if (OsSchedPendSamePriority(taskCB, prev)) {
+        LOS_DL_LIST *groupHead = OS_TCB_FROM_PENDLIST(prev)->pendGroupHead;
+        OS_TCB_FROM_PENDLIST(groupHead)->pendGroupTail = &taskCB->pendList;
+        taskCB->pendGroupHead = groupHead;
+    } else {
+        taskCB->pendGroupHead = &taskCB->pendList;
+        taskCB->pendGroupTail = &taskCB->pendList;
+    }
+}
+
+/* Called before the task is unlinked from its lock pend list */
+STATIC INLINE VOID OsSchedPendGroupDelete(LosTaskCB *taskCB)
+{
+    LOS_DL_LIST *prev = taskCB->pendList.pstPrev;
+    LOS_DL_LIST *next = taskCB->pendList.pstNext;
+    BOOL isGroupHead = !OsSchedPendSamePriority(taskCB, prev);
+    BOOL isGroupTail = !OsSchedPendSamePriority(taskCB, next);
+
+    if (isGroupHead && !isGroupTail) {
+        OS_TCB_FROM_PENDLIST(next)->pendGroupTail = taskCB->pendGroupTail;
+        OS_TCB_FROM_PENDLIST(taskCB->pendGroupTail)->pendGroupHead = next;
+    } else if (!isGroupHead && isGroupTail) {
+        OS_TCB_FROM_PENDLIST(taskCB->pendGroupHead)->pendGroupTail = prev;
+        OS_TCB_FROM_PENDLIST(prev)->pendGroupHead = taskCB->pendGroupHead;
+    }
+
+    taskCB->pendHead = NULL;
+}
+
+STATIC INLINE VOID OsSchedTaskPendDelete(LosTaskCB *taskCB)
+{
+    if (taskCB->pendHead != NULL) {
+        OsSchedPendGroupDelete(taskCB);
     }
+    LOS_ListDelete(&taskCB->pendList);
 }
 
 STATIC INLINE VOID OsSchedWakePendTimeTask(UINT64 currTime, LosTaskCB *taskCB, BOOL *needSchedule)
@@ -476,7 +990,7 @@ STATIC INLINE VOID OsSchedWakePendTimeTask(UINT64 currTime, LosTaskCB *taskCB, B
             taskCB->ipcStatus &= ~IPC_THREAD_STATUS_PEND;
 #endif
             taskCB->taskStatus |= OS_TASK_STATUS_TIMEOUT;
-            LOS_ListDelete(&taskCB->pendList);
+            OsSchedTaskPendDelete(taskCB);
             taskCB->taskMux = NULL;
             OsTaskWakeClearPendMask(taskCB);
         }
@@ -499,7 +1013,6 @@ STATIC INLINE BOOL OsSchedScanTimerList(VOID)
     Percpu *cpu = OsPercpuGet();
     BOOL needSchedule = FALSE;
     SortLinkAttribute *taskSortLink = &OsPercpuGet()->taskSortLink;
-    LOS_DL_LIST *listObject = &taskSortLink->sortLink;
     /*
      * When task is pended with timeout, the task block is on the timeout sortlink
      * (per cpu) and ipc(mutex,sem and etc.)'s block at the same time, it can be waken
@@ -510,14 +1023,9 @@ STATIC INLINE BOOL OsSchedScanTimerList(VOID)
      */
     LOS_SpinLock(&cpu->taskSortLinkSpin);
 
-    if (LOS_ListEmpty(listObject)) {
-        LOS_SpinUnlock(&cpu->taskSortLinkSpin);
-        return needSchedule;
-    }
-
-    SortLinkList *sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
     UINT64 currTime = OsGetCurrSchedTimeCycle();
-    while (sortList->responseTime <= currTime) {
+    SortLinkList *sortList = OsSortLinkGetExpired(taskSortLink, currTime);
+    while (sortList != NULL) {
         LosTaskCB *taskCB = LOS_DL_LIST_ENTRY(sortList, LosTaskCB, sortList);
         OsDeleteNodeSortLink(taskSortLink, &taskCB->sortList);
         LOS_SpinUnlock(&cpu->taskSortLinkSpin);
@@ -525,11 +1033,7 @@ STATIC INLINE BOOL OsSchedScanTimerList(VOID)
         OsSchedWakePendTimeTask(currTime, taskCB, &needSchedule);
 
         LOS_SpinLock(&cpu->taskSortLinkSpin);
-        if (LOS_ListEmpty(listObject)) {
-            break;
-        }
-
-        sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
+        sortList = OsSortLinkGetExpired(taskSortLink, currTime);
     }
 
     LOS_SpinUnlock(&cpu->taskSortLinkSpin);
@@ -541,14 +1045,21 @@ STATIC INLINE VOID OsSchedEnTaskQueue(LosTaskCB *taskCB, LosProcessCB *processCB
 {
     LOS_ASSERT(!(taskCB->taskStatus & OS_TASK_STATUS_READY));
 
+#ifdef LOSCFG_KERNEL_SMP
+    if (taskCB->policy != LOS_SCHED_IDLE) {
+        taskCB->rqCpu = OsSchedSelectRunqueue(taskCB);
+    }
+#endif
+    SchedRunqueue *rq = OsSchedTaskRunqueue(taskCB);
+
     switch (taskCB->policy) {
         case LOS_SCHED_RR: {
             if (taskCB->timeSlice > OS_TIME_SLICE_MIN) {
-                OsSchedPriQueueEnHead(processCB->priority, &taskCB->pendList, taskCB->priority);
+                OsSchedPriQueueEnHead(rq, processCB->priority, &taskCB->pendList, taskCB->priority);
             } else {
-                taskCB->initTimeSlice = OsSchedCalculateTimeSlice(processCB->priority, taskCB->priority);
+                taskCB->initTimeSlice = OsSchedCalculateTimeSlice(rq, processCB->priority, taskCB->priority);
                 taskCB->timeSlice = taskCB->initTimeSlice;
-                OsSchedPriQueueEnTail(processCB->priority, &taskCB->pendList, taskCB->priority);
+                OsSchedPriQueueEnTail(rq, processCB->priority, &taskCB->pendList, taskCB->priority);
 #ifdef LOSCFG_SCHED_DEBUG
                 taskCB->schedStat.timeSliceTime = taskCB->schedStat.timeSliceRealTime;
                 taskCB->schedStat.timeSliceCount++;
@@ -559,14 +1070,18 @@ STATIC INLINE VOID OsSchedEnTaskQueue(LosTaskCB *taskCB, LosProcessCB *processCB
         case LOS_SCHED_FIFO: {
             /* The time slice of FIFO is always greater than 0 unless the yield is called */
             if ((taskCB->timeSlice > OS_TIME_SLICE_MIN) && (taskCB->taskStatus & OS_TASK_STATUS_RUNNING)) {
-                OsSchedPriQueueEnHead(processCB->priority, &taskCB->pendList, taskCB->priority);
+                OsSchedPriQueueEnHead(rq, processCB->priority, &taskCB->pendList, taskCB->priority);
             } else {
                 taskCB->initTimeSlice = OS_SCHED_FIFO_TIMEOUT;
                 taskCB->timeSlice = taskCB->initTimeSlice;
-                OsSchedPriQueueEnTail(processCB->priority, &taskCB->pendList, taskCB->priority);
+                OsSchedPriQueueEnTail(rq, processCB->priority, &taskCB->pendList, taskCB->priority);
             }
             break;
         }
+        case LOS_SCHED_DEADLINE:
+            OsSchedDeadlineReplenish(taskCB, OsGetCurrSchedTimeCycle());
+            OsSchedDeadlineEnQueue(rq, taskCB);
+            break;
         case LOS_SCHED_IDLE:
 #ifdef LOSCFG_SCHED_DEBUG
             taskCB->schedStat.timeSliceCount = 1;
@@ -577,18 +1092,41 @@ STATIC INLINE VOID OsSchedEnTaskQueue(LosTaskCB *taskCB, LosProcessCB *processCB
             break;
     }
 
+#ifdef LOSCFG_KERNEL_SMP
+    if ((taskCB->policy == LOS_SCHED_RR) || (taskCB->policy == LOS_SCHED_FIFO)) {
+        OsSchedStealQueueAdd(rq, processCB->priority, taskCB);
+    }
+#endif
+
     taskCB->taskStatus &= ~OS_TASK_STATUS_BLOCKED;
     taskCB->taskStatus |= OS_TASK_STATUS_READY;
 
     processCB->processStatus &= ~(OS_PROCESS_STATUS_INIT | OS_PROCESS_STATUS_PENDING);
     processCB->processStatus |= OS_PROCESS_STATUS_READY;
     processCB->readyTaskNum++;
+
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+    if (!(taskCB->taskStatus & OS_TASK_STATUS_RUNNING) && (taskCB->policy != LOS_SCHED_IDLE)) {
+        OsSchedLatencyPreemptRequest(rq, taskCB);
+    }
+#endif
+#ifdef LOSCFG_KERNEL_SMP
+    if (!(taskCB->taskStatus & OS_TASK_STATUS_RUNNING) && (taskCB->policy != LOS_SCHED_IDLE)) {
+        OsSchedPreemptCheck(taskCB);
+    }
+#endif
 }
 
 STATIC INLINE VOID OsSchedDeTaskQueue(LosTaskCB *taskCB, LosProcessCB *processCB)
 {
-    if (taskCB->policy != LOS_SCHED_IDLE) {
-        OsSchedPriQueueDelete(processCB->priority, &taskCB->pendList, taskCB->priority);
+    if (taskCB->policy == LOS_SCHED_DEADLINE) {
+        OsSchedDeadlineDeQueue(OsSchedTaskRunqueue(taskCB), taskCB);
+    } else if (taskCB->policy != LOS_SCHED_IDLE) {
+        OsSchedPriQueueDelete(OsSchedTaskRunqueue(taskCB), processCB->priority, &taskCB->pendList,
+                              taskCB->priority);
+#ifdef LOSCFG_KERNEL_SMP
+        OsSchedStealQueueDelete(OsSchedTaskRunqueue(taskCB), processCB->priority, taskCB);
+#endif
     }
     taskCB->taskStatus &= ~OS_TASK_STATUS_READY;
 
@@ -626,6 +1164,20 @@ VOID OsSchedTaskEnQueue(LosTaskCB *taskCB)
         taskCB->startTime = OsGetCurrSchedTimeCycle();
     }
 #endif
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+    if (!(taskCB->taskStatus & OS_TASK_STATUS_RUNNING)) {
+        taskCB->wakeTime = OsGetCurrSchedTimeCycle();
+    }
+#endif
+    if ((taskCB->policy == LOS_SCHED_DEADLINE) && OsSchedDeadlineThrottle(taskCB, OsGetCurrSchedTimeCycle())) {
+        return;
+    }
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+    if (OsSchedBandwidthThrottle(taskCB, OsGetCurrSchedTimeCycle())) {
+        return;
+    }
+#endif
+
     OsSchedEnTaskQueue(taskCB, processCB);
 }
 
@@ -637,7 +1189,7 @@ VOID OsSchedTaskExit(LosTaskCB *taskCB)
         OsSchedTaskDeQueue(taskCB);
         processCB->processStatus &= ~OS_PROCESS_STATUS_PENDING;
     } else if (taskCB->taskStatus & OS_TASK_STATUS_PENDING) {
-        LOS_ListDelete(&taskCB->pendList);
+        OsSchedTaskPendDelete(taskCB);
         taskCB->taskStatus &= ~OS_TASK_STATUS_PENDING;
     }
 
@@ -645,6 +1197,8 @@ VOID OsSchedTaskExit(LosTaskCB *taskCB)
         OsDeleteSortLink(&taskCB->sortList, OS_SORT_LINK_TASK);
         taskCB->taskStatus &= ~(OS_TASK_STATUS_DELAY | OS_TASK_STATUS_PEND_TIME);
     }
+
+    OsSchedDeadlineRelease(taskCB);
 }
 
 VOID OsSchedYield(VOID)
@@ -674,6 +1228,9 @@ UINT32 OsSchedTaskWait(LOS_DL_LIST *list, UINT32 ticks, BOOL needSched)
 
     runTask->taskStatus |= OS_TASK_STATUS_PENDING;
     LOS_ListTailInsert(list, &runTask->pendList);
+    if (runTask->pendHead != NULL) {
+        OsSchedPendGroupAdd(runTask);
+    }
 
     if (ticks != LOS_WAIT_FOREVER) {
         runTask->taskStatus |= OS_TASK_STATUS_PEND_TIME;
@@ -693,7 +1250,7 @@ UINT32 OsSchedTaskWait(LOS_DL_LIST *list, UINT32 ticks, BOOL needSched)
 
 VOID OsSchedTaskWake(LosTaskCB *resumedTask)
 {
-    LOS_ListDelete(&resumedTask->pendList);
+    OsSchedTaskPendDelete(resumedTask);
     resumedTask->taskStatus &= ~OS_TASK_STATUS_PENDING;
 
     if (resumedTask->taskStatus & OS_TASK_STATUS_PEND_TIME) {
@@ -710,11 +1267,104 @@ VOID OsSchedTaskWake(LosTaskCB *resumedTask)
     }
 }
 
+UINT32 OsSchedDeadlineAdmit(const LosTaskCB *taskCB, UINT32 runtime, UINT32 deadline, UINT32 period)
+{
+    UINT64 totalBw = g_sched->dlTotalBw;
+
+    if ((runtime <= (UINT32)OS_TIME_SLICE_MIN) || (runtime > deadline) || (deadline > period)) {
+        return LOS_EINVAL;
+    }
+
+    if (taskCB->policy == LOS_SCHED_DEADLINE) {
+        totalBw -= OsSchedDeadlineBandwidth(taskCB->dlRuntime, taskCB->dlPeriod);
+    }
+
+    UINT64 bandwidth = OsSchedDeadlineBandwidth(runtime, period);
+    if ((bandwidth > OS_SCHED_DL_BW_LIMIT) || ((totalBw + bandwidth) > (OS_SCHED_DL_BW_LIMIT * LOSCFG_KERNEL_CORE_NUM))) {
+        return LOS_EBUSY;
+    }
+
+    return LOS_OK;
+}
+
+/* runtime, deadline and period are in nanoseconds, a zero deadline means the deadline equals the period */
+UINT32 OsSchedModifyTaskDeadlineParam(LosTaskCB *taskCB, UINT64 runtimeNs, UINT64 deadlineNs, UINT64 periodNs,
+                                      BOOL *needSched)
+{
+    if (deadlineNs == 0) {
+        deadlineNs = periodNs;
+    }
+
+    /* check on the requested values, a truncated one could be admitted with other parameters */
+    if ((runtimeNs > deadlineNs) || (deadlineNs > periodNs)) {
+        return LOS_EINVAL;
+    }
+
+    if (((runtimeNs / OS_NS_PER_CYCLE) > OS_32BIT_MAX) || ((deadlineNs / OS_NS_PER_CYCLE) > OS_32BIT_MAX) ||
+        ((periodNs / OS_NS_PER_CYCLE) > OS_32BIT_MAX)) {
+        return LOS_EINVAL;
+    }
+
+    UINT32 runtime = (UINT32)(runtimeNs / OS_NS_PER_CYCLE);
+    UINT32 deadline = (UINT32)(deadlineNs / OS_NS_PER_CYCLE);
+    UINT32 period = (UINT32)(periodNs / OS_NS_PER_CYCLE);
+    UINT32 ret = OsSchedDeadlineAdmit(taskCB, runtime, deadline, period);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    if (taskCB->policy == LOS_SCHED_DEADLINE) {
+        g_sched->dlTotalBw -= OsSchedDeadlineBandwidth(taskCB->dlRuntime, taskCB->dlPeriod);
+        g_sched->dlTotalBw += OsSchedDeadlineBandwidth(runtime, period);
+        taskCB->timeSlice = 0;
+    }
+
+    taskCB->dlRuntime = runtime;
+    taskCB->dlDeadline = deadline;
+    taskCB->dlPeriod = period;
+    taskCB->dlAbsDeadline = 0;
+
+    *needSched = OsSchedModifyTaskSchedParam(taskCB, LOS_SCHED_DEADLINE, taskCB->priority);
+    return LOS_OK;
+}
+
+VOID OsSchedGetTaskDeadlineParam(const LosTaskCB *taskCB, UINT64 *runtimeNs, UINT64 *deadlineNs, UINT64 *periodNs)
+{
+    *runtimeNs = (UINT64)taskCB->dlRuntime * OS_NS_PER_CYCLE;
+    *deadlineNs = (UINT64)taskCB->dlDeadline * OS_NS_PER_CYCLE;
+    *periodNs = (UINT64)taskCB->dlPeriod * OS_NS_PER_CYCLE;
+}
+
+VOID OsSchedDeadlineRelease(LosTaskCB *taskCB)
+{
+    if (taskCB->policy == LOS_SCHED_DEADLINE) {
+        g_sched->dlTotalBw -= OsSchedDeadlineBandwidth(taskCB->dlRuntime, taskCB->dlPeriod);
+        taskCB->policy = LOS_SCHED_RR;
+    }
+}
+
 BOOL OsSchedModifyTaskSchedParam(LosTaskCB *taskCB, UINT16 policy, UINT16 priority)
 {
     if (taskCB->policy != policy) {
+        BOOL isReady = ((taskCB->taskStatus & OS_TASK_STATUS_READY) != 0);
+        if (isReady) {
+            OsSchedTaskDeQueue(taskCB);
+        }
+
+        /* The reservation of a new deadline task has been admitted by OsSchedDeadlineAdmit */
+        OsSchedDeadlineRelease(taskCB);
+        if (policy == LOS_SCHED_DEADLINE) {
+            g_sched->dlTotalBw += OsSchedDeadlineBandwidth(taskCB->dlRuntime, taskCB->dlPeriod);
+            taskCB->dlAbsDeadline = 0;
+        }
         taskCB->policy = policy;
         taskCB->timeSlice = 0;
+
+        if (isReady) {
+            taskCB->priority = priority;
+            OsSchedTaskEnQueue(taskCB);
+            return TRUE;
+        }
     }
 
     if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
@@ -724,6 +1374,15 @@ BOOL OsSchedModifyTaskSchedParam(LosTaskCB *taskCB, UINT16 policy, UINT16 priori
         return TRUE;
     }
 
+    if ((taskCB->taskStatus & OS_TASK_STATUS_PENDING) && (taskCB->pendHead != NULL)) {
+        /* Move the waiter to its new place in the lock pend list */
+        LOS_DL_LIST *pendHead = taskCB->pendHead;
+        OsSchedTaskPendDelete(taskCB);
+        taskCB->priority = priority;
+        LOS_ListTailInsert(OsSchedLockPendFindPos(taskCB, pendHead), &taskCB->pendList);
+        OsSchedPendGroupAdd(taskCB);
+    }
+
     taskCB->priority = priority;
     OsHookCall(LOS_HOOK_TYPE_TASK_PRIMODIFY, taskCB, taskCB->priority); 
     if (taskCB->taskStatus & OS_TASK_STATUS_INIT) {
@@ -732,6 +1391,9 @@ BOOL OsSchedModifyTaskSchedParam(LosTaskCB *taskCB, UINT16 policy, UINT16 priori
     }
 
     if (taskCB->taskStatus & OS_TASK_STATUS_RUNNING) {
+#ifdef LOSCFG_KERNEL_SMP
+        OsSchedPreemptMark(taskCB->currCpu);
+#endif
         return TRUE;
     }
 
@@ -746,9 +1408,15 @@ BOOL OsSchedModifyProcessSchedParam(LosProcessCB *processCB, UINT16 policy, UINT
 
     if (processCB->processStatus & OS_PROCESS_STATUS_READY) {
         LOS_DL_LIST_FOR_EACH_ENTRY(taskCB, &processCB->threadSiblingList, LosTaskCB, threadList) {
-            if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
-                OsSchedPriQueueDelete(processCB->priority, &taskCB->pendList, taskCB->priority);
-                OsSchedPriQueueEnTail(priority, &taskCB->pendList, taskCB->priority);
+            /* Deadline tasks are ordered by deadline only */
+            if ((taskCB->taskStatus & OS_TASK_STATUS_READY) && (taskCB->policy != LOS_SCHED_DEADLINE)) {
+                SchedRunqueue *rq = OsSchedTaskRunqueue(taskCB);
+                OsSchedPriQueueDelete(rq, processCB->priority, &taskCB->pendList, taskCB->priority);
+                OsSchedPriQueueEnTail(rq, priority, &taskCB->pendList, taskCB->priority);
+#ifdef LOSCFG_KERNEL_SMP
+                OsSchedStealQueueDelete(rq, processCB->priority, taskCB);
+                OsSchedStealQueueAdd(rq, priority, taskCB);
+#endif
                 needSched = TRUE;
             }
         }
@@ -759,6 +1427,16 @@ BOOL OsSchedModifyProcessSchedParam(LosProcessCB *processCB, UINT16 policy, UINT
         needSched = TRUE;
     }
 
+#ifdef LOSCFG_KERNEL_SMP
+    LOS_DL_LIST_FOR_EACH_ENTRY(taskCB, &processCB->threadSiblingList, LosTaskCB, threadList) {
+        if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
+            OsSchedPreemptCheck(taskCB);
+        } else if (taskCB->taskStatus & OS_TASK_STATUS_RUNNING) {
+            OsSchedPreemptMark(taskCB->currCpu);
+        }
+    }
+#endif
+
     return needSched;
 }
 
@@ -770,6 +1448,13 @@ VOID OsSchedTick(VOID)
     LosTaskCB *runTask = OsCurrTaskGet();
 
     currCpu->tickStartTime = runTask->irqStartTime;
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+    if (currCpu->responseTime != OS_SCHED_MAX_RESPONSE_TIME) {
+        UINT64 tickError = (currCpu->tickStartTime > currCpu->responseTime) ?
+                           (currCpu->tickStartTime - currCpu->responseTime) : 0;
+        OsSchedLatencyRecord(OS_SCHED_LAT_TICK, runTask->priority, tickError);
+    }
+#endif
     if (currCpu->responseID == OS_INVALID_VALUE) {
         if (sched->swtmrScan != NULL) {
             (VOID)sched->swtmrScan();
@@ -806,7 +1491,7 @@ UINT32 OsSchedSwtmrScanRegister(SchedScan func)
 
 UINT32 OsSchedInit(VOID)
 {
-    UINT16 index, pri;
+    UINT16 index, proPri, pri;
     UINT32 ret;
 
     g_sched = (Sched *)LOS_MemAlloc(m_aucSysMem0, sizeof(Sched));
@@ -816,11 +1501,20 @@ UINT32 OsSchedInit(VOID)
 
     (VOID)memset_s(g_sched, sizeof(Sched), 0, sizeof(Sched));
 
-    for (index = 0; index < OS_PRIORITY_QUEUE_NUM; index++) {
-        SchedQueue *queueList = &g_sched->queueList[index];
-        LOS_DL_LIST *priList = &queueList->priQueueList[0];
-        for (pri = 0; pri < OS_PRIORITY_QUEUE_NUM; pri++) {
-            LOS_ListInit(&priList[pri]);
+    for (index = 0; index < LOSCFG_KERNEL_CORE_NUM; index++) {
+        SchedRunqueue *rq = OsSchedRunqueueByID(index);
+        LOS_ListInit(&rq->dlQueue);
+        for (proPri = 0; proPri < OS_PRIORITY_QUEUE_NUM; proPri++) {
+            LOS_DL_LIST *priList = &rq->queueList[proPri].priQueueList[0];
+            for (pri = 0; pri < OS_PRIORITY_QUEUE_NUM; pri++) {
+                LOS_ListInit(&priList[pri]);
+            }
+#ifdef LOSCFG_KERNEL_SMP
+            priList = &rq->stealQueue[proPri].priQueueList[0];
+            for (pri = 0; pri < OS_PRIORITY_QUEUE_NUM; pri++) {
+                LOS_ListInit(&priList[pri]);
+            }
+#endif
         }
     }
 
@@ -846,39 +1540,126 @@ UINT32 OsSchedInit(VOID)
     return LOS_OK;
 }
 
-STATIC LosTaskCB *OsGetTopTask(VOID)
+STATIC INLINE UINT32 OsSchedRunqueueTopKey(const SchedRunqueue *rq)
+{
+    if (rq->queueBitmap == 0) {
+        return OS_SCHED_PRIORITY_KEY_MAX;
+    }
+
+    UINT32 processPriority = CLZ(rq->queueBitmap);
+    return OS_SCHED_PRIORITY_KEY(processPriority, CLZ(rq->queueList[processPriority].queueBitmap));
+}
+
+#ifdef LOSCFG_KERNEL_SMP
+/*
+ * Look for a task on another cpu's run queue that may run on this cpu and whose
+ * priority is higher than limitKey. Only the steal queue is scanned, so tasks pinned
+ * to the other cpu cost nothing, and scanning stops as soon as the queue priority
+ * reaches the limit, so a cpu only steals work it would have preempted for anyway.
+ */
+STATIC LosTaskCB *OsSchedStealTask(const SchedRunqueue *rq, UINT16 cpuid, UINT32 limitKey)
 {
     UINT32 priority, processPriority;
     UINT32 bitmap;
-    LosTaskCB *newTask = NULL;
-    UINT32 processBitmap = g_sched->queueBitmap;
-#ifdef LOSCFG_KERNEL_SMP
-    UINT32 cpuid = ArchCurrCpuid();
-#endif
+    LosTaskCB *taskCB = NULL;
+    UINT32 processBitmap = rq->stealBitmap;
 
     while (processBitmap) {
         processPriority = CLZ(processBitmap);
-        SchedQueue *queueList = &g_sched->queueList[processPriority];
-        bitmap = queueList->queueBitmap;
-            while (bitmap) {
-                priority = CLZ(bitmap);
-                LOS_DL_LIST_FOR_EACH_ENTRY(newTask, &queueList->priQueueList[priority], LosTaskCB, pendList) {
-#ifdef LOSCFG_KERNEL_SMP
-                    if (newTask->cpuAffiMask & (1U << cpuid)) {
-#endif
-                        goto FIND_TASK;
-#ifdef LOSCFG_KERNEL_SMP
-                    }
-#endif
+        const SchedStealQueue *queue = &rq->stealQueue[processPriority];
+        bitmap = queue->queueBitmap;
+        while (bitmap) {
+            priority = CLZ(bitmap);
+            if (OS_SCHED_PRIORITY_KEY(processPriority, priority) >= limitKey) {
+                return NULL;
+            }
+
+            LOS_DL_LIST_FOR_EACH_ENTRY(taskCB, &queue->priQueueList[priority], LosTaskCB, stealList) {
+                if (taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid)) {
+                    return taskCB;
                 }
+            }
             bitmap &= ~(1U << (OS_PRIORITY_QUEUE_NUM - priority - 1));
         }
         processBitmap &= ~(1U << (OS_PRIORITY_QUEUE_NUM - processPriority - 1));
     }
 
-    newTask = OS_TCB_FROM_TID(OsPercpuGet()->idleTaskID);
+    return NULL;
+}
+#endif
+
+/*
+ * Deadline tasks run ahead of all fixed priority tasks. A cpu picks the earliest deadline
+ * among its own queue and those of other cpus, so the deadline class is scheduled globally.
+ */
+STATIC LosTaskCB *OsSchedDeadlineTopTask(UINT16 cpuid)
+{
+    LosTaskCB *newTask = NULL;
+    SchedRunqueue *rq = OsSchedRunqueueByID(cpuid);
+
+    if (!LOS_ListEmpty(&rq->dlQueue)) {
+        newTask = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(&rq->dlQueue));
+    }
+
+#ifdef LOSCFG_KERNEL_SMP
+    for (UINT16 index = 1; index < LOSCFG_KERNEL_CORE_NUM; index++) {
+        SchedRunqueue *remoteRq = OsSchedRunqueueByID((cpuid + index) % LOSCFG_KERNEL_CORE_NUM);
+        LosTaskCB *taskCB = NULL;
+
+        LOS_DL_LIST_FOR_EACH_ENTRY(taskCB, &remoteRq->dlQueue, LosTaskCB, pendList) {
+            if ((newTask != NULL) && (taskCB->dlAbsDeadline >= newTask->dlAbsDeadline)) {
+                break;
+            }
+
+            if (taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid)) {
+                newTask = taskCB;
+                break;
+            }
+        }
+    }
+#endif
+
+    return newTask;
+}
+
+STATIC LosTaskCB *OsGetTopTask(VOID)
+{
+    UINT16 cpuid = ArchCurrCpuid();
+    LosTaskCB *newTask = OsSchedDeadlineTopTask(cpuid);
+    if (newTask != NULL) {
+        OsSchedDeTaskQueue(newTask, OS_PCB_FROM_PID(newTask->processID));
+        return newTask;
+    }
+
+    SchedRunqueue *rq = OsSchedRunqueueByID(cpuid);
+    UINT32 topKey = OsSchedRunqueueTopKey(rq);
+
+    /* Every task on the local run queue is allowed to run on this cpu */
+    if (topKey != OS_SCHED_PRIORITY_KEY_MAX) {
+        SchedQueue *queueList = &rq->queueList[OS_SCHED_KEY_PROCESS_PRIORITY(topKey)];
+        newTask = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(&queueList->priQueueList[OS_SCHED_KEY_PRIORITY(topKey)]));
+    }
+
+#ifdef LOSCFG_KERNEL_SMP
+    for (UINT16 index = 1; index < LOSCFG_KERNEL_CORE_NUM; index++) {
+        UINT16 remote = (cpuid + index) % LOSCFG_KERNEL_CORE_NUM;
+        SchedRunqueue *remoteRq = OsSchedRunqueueByID(remote);
+        if ((remoteRq->stealBitmap == 0) || (OsSchedRunqueueTopKey(remoteRq) >= topKey)) {
+            continue;
+        }
+
+        LosTaskCB *taskCB = OsSchedStealTask(remoteRq, cpuid, topKey);
+        if (taskCB != NULL) {
+            newTask = taskCB;
+            topKey = OsSchedTaskKey(taskCB);
+        }
+    }
+#endif
+
+    if (newTask == NULL) {
+        newTask = OS_TCB_FROM_TID(OsPercpuGet()->idleTaskID);
+    }
 
-FIND_TASK:
     OsSchedDeTaskQueue(newTask, OS_PCB_FROM_PID(newTask->processID));
     return newTask;
 }
@@ -911,6 +1692,7 @@ VOID OsSchedStart(VOID)
      */
     newTask->currCpu = cpuid;
 #endif
+    OsSchedRunqueueByID(cpuid)->runTask = newTask;
 
     OsCurrTaskSet((VOID *)newTask);
 
@@ -991,9 +1773,11 @@ STATIC VOID OsSchedTaskSwicth(LosTaskCB *runTask, LosTaskCB *newTask)
 
 #ifdef LOSCFG_KERNEL_SMP
     /* mask new running task's owner processor */
+    runTask->lastCpu = runTask->currCpu;
     runTask->currCpu = OS_TASK_INVALID_CPUID;
     newTask->currCpu = ArchCurrCpuid();
 #endif
+    OsSchedRunqueueByID(ArchCurrCpuid())->runTask = newTask;
 
     OsCurrTaskSet((VOID *)newTask);
     LosProcessCB *newProcess = OS_PCB_FROM_PID(newTask->processID);
@@ -1026,12 +1810,21 @@ STATIC VOID OsSchedTaskSwicth(LosTaskCB *runTask, LosTaskCB *newTask)
             OsAdd2SortLink(&runTask->sortList, runTask->startTime, runTask->waitTimes, OS_SORT_LINK_TASK);
         }
     }
+#ifdef LOSCFG_KERNEL_SMP
+    runTask->lastRunTime = newTask->startTime;
+#endif
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+    OsSchedLatencySwitch(OsSchedRunqueueByID(ArchCurrCpuid()), runTask, newTask, newTask->startTime);
+#endif
 
-    if (newTask->policy == LOS_SCHED_RR) {
+    if ((newTask->policy == LOS_SCHED_RR) || (newTask->policy == LOS_SCHED_DEADLINE)) {
         endTime = newTask->startTime + newTask->timeSlice;
     } else {
         endTime = OS_SCHED_MAX_RESPONSE_TIME - OS_TICK_RESPONSE_PRECISION;
     }
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+    endTime = OsSchedBandwidthEndTime(newTask, newTask->startTime, endTime);
+#endif
     OsSchedSetNextExpireTime(newTask->startTime, newTask->taskID, endTime, runTask->taskID);
 
 #ifdef LOSCFG_SCHED_DEBUG
@@ -1053,6 +1846,11 @@ VOID OsSchedIrqEndCheckNeedSched(VOID)
     if (runTask->timeSlice <= OS_TIME_SLICE_MIN) {
         percpu->schedFlag |= INT_PEND_RESCH;
     }
+#ifdef LOSCFG_KERNEL_SCHED_BANDWIDTH
+    if (OsSchedBandwidthExhausted(runTask)) {
+        percpu->schedFlag |= INT_PEND_RESCH;
+    }
+#endif
 
     if (OsPreemptable() && (percpu->schedFlag & INT_PEND_RESCH)) {
         percpu->schedFlag &= ~INT_PEND_RESCH;
@@ -1067,6 +1865,9 @@ VOID OsSchedIrqEndCheckNeedSched(VOID)
             LOS_SpinUnlock(&g_taskSpin);
             return;
         }
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+        OsSchedRunqueueByID(ArchCurrCpuid())->preemptTime = 0;
+#endif
 
         LOS_SpinUnlock(&g_taskSpin);
     }
@@ -1089,6 +1890,9 @@ VOID OsSchedResched(VOID)
     LosTaskCB *runTask = OsCurrTaskGet();
     LosTaskCB *newTask = OsGetTopTask();
     if (runTask == newTask) {
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+        OsSchedRunqueueByID(ArchCurrCpuid())->preemptTime = 0;
+#endif
         return;
     }
 
@@ -1127,41 +1931,25 @@ VOID LOS_Schedule(VOID)
     SCHEDULER_UNLOCK(intSave);
 }
 
-STATIC INLINE LOS_DL_LIST *OsSchedLockPendFindPosSub(const LosTaskCB *runTask, const LOS_DL_LIST *lockList)
+LOS_DL_LIST *OsSchedLockPendFindPos(LosTaskCB *runTask, LOS_DL_LIST *lockList)
 {
-    LosTaskCB *pendedTask = NULL;
-    LOS_DL_LIST *node = NULL;
+    LOS_DL_LIST *node = lockList->pstNext;
 
-    LOS_DL_LIST_FOR_EACH_ENTRY(pendedTask, lockList, LosTaskCB, pendList) {
-        if (pendedTask->priority < runTask->priority) {
-            continue;
-        } else if (pendedTask->priority > runTask->priority) {
-            node = &pendedTask->pendList;
-            break;
-        } else {
-            node = pendedTask->pendList.pstNext;
-            break;
-        }
+    runTask->pendHead = lockList;
+    if (LOS_ListEmpty(lockList) || (OS_TCB_FROM_PENDLIST(lockList->pstPrev)->priority <= runTask->priority)) {
+        return lockList;
     }
 
-    return node;
-}
-
-LOS_DL_LIST *OsSchedLockPendFindPos(const LosTaskCB *runTask, LOS_DL_LIST *lockList)
-{
-    LOS_DL_LIST *node = NULL;
+    while (node != lockList) {
+        LosTaskCB *groupHead = OS_TCB_FROM_PENDLIST(node);
+        if (groupHead->priority > runTask->priority) {
+            break;
+        }
 
-    if (LOS_ListEmpty(lockList)) {
-        node = lockList;
-    } else {
-        LosTaskCB *pendedTask1 = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(lockList));
-        LosTaskCB *pendedTask2 = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_LAST(lockList));
-        if (pendedTask1->priority > runTask->priority) {
-            node = lockList->pstNext;
-        } else if (pendedTask2->priority <= runTask->priority) {
-            node = lockList;
-        } else {
-            node = OsSchedLockPendFindPosSub(runTask, lockList);
+        /* Behind the last waiter of the same priority, or on to the next priority */
+        node = groupHead->pendGroupTail->pstNext;
+        if (groupHead->priority == runTask->priority) {
+            break;
         }
     }
 
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_sched_pri.h"
+#include "los_seq_buf.h"
+#include "securec.h"
+
+#ifdef LOSCFG_KERNEL_SCHED_LATENCY
+#define OS_SCHED_LATENCY_BAND_SHIFT   3 /* 8 task priorities per band */
+#define OS_SCHED_LATENCY_BAND_NUM     ((OS_TASK_PRIORITY_LOWEST + 1) >> OS_SCHED_LATENCY_BAND_SHIFT)
+#define OS_SCHED_LATENCY_BUCKET_NUM   16 /* Bucket n counts [2^(n-1), 2^n) us, the last one is unbounded */
+
+typedef struct {
+    UINT32 bucket[OS_SCHED_LATENCY_BAND_NUM][OS_SCHED_LATENCY_BUCKET_NUM];
+    UINT64 max[OS_SCHED_LATENCY_BAND_NUM];    /* in cycles */
+} SchedLatencyHist;
+
+typedef struct {
+    SchedLatencyHist hist[OS_SCHED_LAT_TYPE_MAX];
+} SchedLatency;
+
+STATIC SchedLatency g_schedLatency[LOSCFG_KERNEL_CORE_NUM];
+
+STATIC const CHAR *g_schedLatencyName[OS_SCHED_LAT_TYPE_MAX] = {
+    "wakeup", "timeslice", "tick", "preempt"
+};
+
+/* Called with interrupts disabled on the cpu that owns the histogram, so no lock is taken */
+VOID OsSchedLatencyRecord(SchedLatencyType type, UINT16 priority, UINT64 cycles)
+{
+    SchedLatencyHist *hist = &g_schedLatency[ArchCurrCpuid()].hist[type];
+    UINT32 band = (UINT32)priority >> OS_SCHED_LATENCY_BAND_SHIFT;
+    UINT64 us = (cycles * OS_NS_PER_CYCLE) / OS_SYS_NS_PER_US;
+    UINT32 index;
+
+    if (band >= OS_SCHED_LATENCY_BAND_NUM) {
+        band = OS_SCHED_LATENCY_BAND_NUM - 1;
+    }
+
+    if (us == 0) {
+        index = 0;
+    } else if (us >= (1ULL << (OS_SCHED_LATENCY_BUCKET_NUM - 2))) {
+        index = OS_SCHED_LATENCY_BUCKET_NUM - 1;
+    } else {
+        index = 32 - CLZ((UINT32)us); /* 32: bits of UINT32 */
+    }
+
+    hist->bucket[band][index]++;
+    if (cycles > hist->max[band]) {
+        hist->max[band] = cycles;
+    }
+}
+
+VOID OsSchedLatencyReset(VOID)
+{
+    UINT32 intSave = LOS_IntLock();
+    (VOID)memset_s(g_schedLatency, sizeof(g_schedLatency), 0, sizeof(g_schedLatency));
+    LOS_IntRestore(intSave);
+}
+
+STATIC VOID OsSchedLatencyShowHist(struct SeqBuf *seqBuf, const SchedLatencyHist *hist)
+{
+    UINT32 band, index;
+
+    (VOID)LosBufPrintf(seqBuf, "%-8s", "prio");
+    for (index = 0; index < (OS_SCHED_LATENCY_BUCKET_NUM - 1); index++) {
+        (VOID)LosBufPrintf(seqBuf, " <%-8u", 1U << index);
+    }
+    (VOID)LosBufPrintf(seqBuf, " >=%-7u %s\n", 1U << (OS_SCHED_LATENCY_BUCKET_NUM - 2), "max(us)");
+
+    for (band = 0; band < OS_SCHED_LATENCY_BAND_NUM; band++) {
+        (VOID)LosBufPrintf(seqBuf, "%2u-%-5u", band << OS_SCHED_LATENCY_BAND_SHIFT,
+                           ((band + 1) << OS_SCHED_LATENCY_BAND_SHIFT) - 1);
+        for (index = 0; index < OS_SCHED_LATENCY_BUCKET_NUM; index++) {
+            (VOID)LosBufPrintf(seqBuf, " %-9u", hist->bucket[band][index]);
+        }
+        (VOID)LosBufPrintf(seqBuf, " %llu\n", (hist->max[band] * OS_NS_PER_CYCLE) / OS_SYS_NS_PER_US);
+    }
+}
+
+VOID OsSchedLatencyShow(struct SeqBuf *seqBuf)
+{
+    UINT32 cpuid, type;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        for (type = 0; type < OS_SCHED_LAT_TYPE_MAX; type++) {
+            (VOID)LosBufPrintf(seqBuf, "cpu%u %s (us)\n", cpuid, g_schedLatencyName[type]);
+            OsSchedLatencyShowHist(seqBuf, &g_schedLatency[cpuid].hist[type]);
+        }
+    }
+}
+#endif
@@ -36,69 +36,271 @@
 #include "los_sched_pri.h"
 #include "los_mp.h"
 
+#define OS_SORT_LINK_OVERFLOW_SHIFT (OS_SORT_LINK_WHEEL_BITS * OS_SORT_LINK_WHEEL_LEVELS)
+
 UINT32 OsSortLinkInit(SortLinkAttribute *sortLinkHeader)
 {
-    LOS_ListInit(&sortLinkHeader->sortLink);
+    UINT32 level, slot;
+
+    for (level = 0; level < OS_SORT_LINK_WHEEL_LEVELS; level++) {
+        SortLinkWheel *wheel = &sortLinkHeader->wheel[level];
+        for (slot = 0; slot < OS_SORT_LINK_WHEEL_SLOTS; slot++) {
+            LOS_ListInit(&wheel->slot[slot]);
+        }
+        wheel->bitmap = 0;
+    }
+    LOS_ListInit(&sortLinkHeader->overflow);
+    sortLinkHeader->baseTick = 0;
     sortLinkHeader->nodeNum = 0;
     return LOS_OK;
 }
 
-STATIC INLINE VOID OsAddNode2SortLink(SortLinkAttribute *sortLinkHeader, SortLinkList *sortList)
+STATIC INLINE UINT64 OsSortLinkNodeTick(const SortLinkAttribute *sortLinkHeader, const SortLinkList *sortList)
 {
-    LOS_DL_LIST *head = (LOS_DL_LIST *)&sortLinkHeader->sortLink;
+    UINT64 tick = sortList->responseTime / OS_CYCLE_PER_TICK;
 
-    if (LOS_ListEmpty(head)) {
-        LOS_ListHeadInsert(head, &sortList->sortLinkNode);
-        sortLinkHeader->nodeNum++;
-        return;
+    /* A node that has already expired is kept on the slot of the base tick */
+    return (tick < sortLinkHeader->baseTick) ? sortLinkHeader->baseTick : tick;
+}
+
+/*
+ * Find the list a node belongs to for the current base tick, the node position only
+ * depends on its tick and the base tick, so it is recomputed instead of being stored.
+ */
+STATIC LOS_DL_LIST *OsSortLinkSlotGet(SortLinkAttribute *sortLinkHeader, const SortLinkList *sortList,
+                                      UINT32 *level, UINT32 *slot)
+{
+    UINT64 tick = OsSortLinkNodeTick(sortLinkHeader, sortList);
+    UINT64 diff = (tick ^ sortLinkHeader->baseTick) >> OS_SORT_LINK_WHEEL_BITS;
+    UINT32 index = 0;
+
+    while (diff != 0) {
+        index++;
+        diff >>= OS_SORT_LINK_WHEEL_BITS;
+    }
+
+    *level = index;
+    if (index >= OS_SORT_LINK_WHEEL_LEVELS) {
+        *slot = 0;
+        return &sortLinkHeader->overflow;
+    }
+
+    *slot = (UINT32)(tick >> (index * OS_SORT_LINK_WHEEL_BITS)) & OS_SORT_LINK_WHEEL_MASK;
+    return &sortLinkHeader->wheel[index].slot[*slot];
+}
+
+STATIC INLINE VOID OsSortLinkInsert(SortLinkAttribute *sortLinkHeader, SortLinkList *sortList)
+{
+    UINT32 level, slot;
+    LOS_DL_LIST *list = OsSortLinkSlotGet(sortLinkHeader, sortList, &level, &slot);
+
+    LOS_ListTailInsert(list, &sortList->sortLinkNode);
+    if (level < OS_SORT_LINK_WHEEL_LEVELS) {
+        sortLinkHeader->wheel[level].bitmap |= 1U << slot;
+    }
+}
+
+STATIC INLINE VOID OsSortLinkRemove(SortLinkAttribute *sortLinkHeader, SortLinkList *sortList)
+{
+    UINT32 level, slot;
+    LOS_DL_LIST *list = OsSortLinkSlotGet(sortLinkHeader, sortList, &level, &slot);
+
+    LOS_ListDelete(&sortList->sortLinkNode);
+    if ((level < OS_SORT_LINK_WHEEL_LEVELS) && LOS_ListEmpty(list)) {
+        sortLinkHeader->wheel[level].bitmap &= ~(1U << slot);
     }
+}
+
+STATIC INLINE VOID OsSortLinkCascade(SortLinkAttribute *sortLinkHeader, LOS_DL_LIST *list)
+{
+    LOS_DL_LIST head;
+    SortLinkList *sortList = NULL;
 
-    SortLinkList *listSorted = LOS_DL_LIST_ENTRY(head->pstNext, SortLinkList, sortLinkNode);
-    if (listSorted->responseTime > sortList->responseTime) {
-        LOS_ListAdd(head, &sortList->sortLinkNode);
-        sortLinkHeader->nodeNum++;
+    if (LOS_ListEmpty(list)) {
         return;
-    } else if (listSorted->responseTime == sortList->responseTime) {
-        LOS_ListAdd(head->pstNext, &sortList->sortLinkNode);
-        sortLinkHeader->nodeNum++;
+    }
+
+    /* Detach the whole slot first, the nodes are put back relative to the new base tick */
+    head.pstNext = list->pstNext;
+    head.pstPrev = list->pstPrev;
+    head.pstNext->pstPrev = &head;
+    head.pstPrev->pstNext = &head;
+    LOS_ListInit(list);
+
+    while (!LOS_ListEmpty(&head)) {
+        sortList = LOS_DL_LIST_ENTRY(head.pstNext, SortLinkList, sortLinkNode);
+        LOS_ListDelete(&sortList->sortLinkNode);
+        OsSortLinkInsert(sortLinkHeader, sortList);
+    }
+}
+
+/*
+ * Move the base tick forward. Callers only move it up to the earliest tick on the
+ * wheel, which keeps every wheel node on its slot; overflow nodes are re-placed when
+ * the digits above the top level change.
+ */
+STATIC INLINE VOID OsSortLinkBaseSet(SortLinkAttribute *sortLinkHeader, UINT64 tick)
+{
+    UINT64 oldTick = sortLinkHeader->baseTick;
+
+    if (tick <= oldTick) {
         return;
     }
 
-    LOS_DL_LIST *prevNode = head->pstPrev;
-    do {
-        listSorted = LOS_DL_LIST_ENTRY(prevNode, SortLinkList, sortLinkNode);
-        if (listSorted->responseTime <= sortList->responseTime) {
-            LOS_ListAdd(prevNode, &sortList->sortLinkNode);
-            sortLinkHeader->nodeNum++;
+    sortLinkHeader->baseTick = tick;
+    if ((tick >> OS_SORT_LINK_OVERFLOW_SHIFT) != (oldTick >> OS_SORT_LINK_OVERFLOW_SHIFT)) {
+        OsSortLinkCascade(sortLinkHeader, &sortLinkHeader->overflow);
+    }
+}
+
+/* Return the lowest non-empty level and its first slot, the earliest nodes live there */
+STATIC INLINE UINT32 OsSortLinkFirstSlot(const SortLinkAttribute *sortLinkHeader, UINT32 *slot)
+{
+    UINT32 level;
+
+    for (level = 0; level < OS_SORT_LINK_WHEEL_LEVELS; level++) {
+        UINT32 bitmap = sortLinkHeader->wheel[level].bitmap;
+        if (bitmap != 0) {
+            *slot = CTZ(bitmap);
+            return level;
+        }
+    }
+
+    return OS_SORT_LINK_WHEEL_LEVELS;
+}
+
+STATIC INLINE UINT64 OsSortLinkSlotStartTick(const SortLinkAttribute *sortLinkHeader, UINT32 level, UINT32 slot)
+{
+    UINT32 shift = level * OS_SORT_LINK_WHEEL_BITS;
+    UINT64 upper = (sortLinkHeader->baseTick >> (shift + OS_SORT_LINK_WHEEL_BITS)) << OS_SORT_LINK_WHEEL_BITS;
+
+    return (upper | slot) << shift;
+}
+
+STATIC UINT64 OsSortLinkOverflowMinTick(SortLinkAttribute *sortLinkHeader)
+{
+    SortLinkList *sortList = NULL;
+    UINT64 minTick = OS_SORT_LINK_INVALID_TIME;
+
+    LOS_DL_LIST_FOR_EACH_ENTRY(sortList, &sortLinkHeader->overflow, SortLinkList, sortLinkNode) {
+        UINT64 tick = OsSortLinkNodeTick(sortLinkHeader, sortList);
+        if (tick < minTick) {
+            minTick = tick;
+        }
+    }
+
+    return minTick;
+}
+
+/*
+ * Return a node whose response time is not later than currTime, or NULL if there is
+ * none. The node stays on the sort link until the caller deletes it. Finding it moves
+ * the base tick towards currTime and cascades the slots it passes.
+ */
+SortLinkList *OsSortLinkGetExpired(SortLinkAttribute *sortLinkHeader, UINT64 currTime)
+{
+    UINT64 currTick = currTime / OS_CYCLE_PER_TICK;
+    SortLinkList *sortList = NULL;
+    UINT32 level, slot;
+
+    while (sortLinkHeader->nodeNum != 0) {
+        level = OsSortLinkFirstSlot(sortLinkHeader, &slot);
+        if (level == OS_SORT_LINK_WHEEL_LEVELS) {
+            /* Only overflow nodes are left, move the base to the earliest of them if it is due */
+            UINT64 minTick = OsSortLinkOverflowMinTick(sortLinkHeader);
+            if (minTick > currTick) {
+                break;
+            }
+            OsSortLinkBaseSet(sortLinkHeader, minTick);
+            continue;
+        }
+
+        UINT64 startTick = OsSortLinkSlotStartTick(sortLinkHeader, level, slot);
+        if (startTick > currTick) {
             break;
         }
 
-        prevNode = prevNode->pstPrev;
-    } while (1);
+        OsSortLinkBaseSet(sortLinkHeader, startTick);
+        LOS_DL_LIST *list = &sortLinkHeader->wheel[level].slot[slot];
+        if (level != 0) {
+            sortLinkHeader->wheel[level].bitmap &= ~(1U << slot);
+            OsSortLinkCascade(sortLinkHeader, list);
+            continue;
+        }
+
+        LOS_DL_LIST_FOR_EACH_ENTRY(sortList, list, SortLinkList, sortLinkNode) {
+            if (sortList->responseTime <= currTime) {
+                return sortList;
+            }
+        }
+
+        /* The remaining nodes of the current tick expire later within this tick */
+        return NULL;
+    }
+
+    OsSortLinkBaseSet(sortLinkHeader, currTick);
+    return NULL;
+}
+
+STATIC INLINE VOID OsAddNode2SortLink(SortLinkAttribute *sortLinkHeader, SortLinkList *sortList)
+{
+    OsSortLinkInsert(sortLinkHeader, sortList);
+    sortLinkHeader->nodeNum++;
 }
 
 VOID OsDeleteNodeSortLink(SortLinkAttribute *sortLinkHeader, SortLinkList *sortList)
 {
-    LOS_ListDelete(&sortList->sortLinkNode);
+    OsSortLinkRemove(sortLinkHeader, sortList);
     SET_SORTLIST_VALUE(sortList, OS_SORT_LINK_INVALID_TIME);
     sortLinkHeader->nodeNum--;
 }
 
+/*
+ * The earliest response time on the sort link. Nodes on a level above zero are not
+ * ordered within their slot, the start of that slot is returned instead, the tick
+ * interrupt at that time cascades the slot and the exact time is known afterwards.
+ */
+STATIC UINT64 OsSortLinkFirstResponseTime(SortLinkAttribute *sortLinkHeader)
+{
+    SortLinkList *sortList = NULL;
+    UINT64 responseTime = OS_SORT_LINK_INVALID_TIME;
+    UINT32 slot;
+
+    if (sortLinkHeader->nodeNum == 0) {
+        return OS_SORT_LINK_INVALID_TIME;
+    }
+
+    UINT32 level = OsSortLinkFirstSlot(sortLinkHeader, &slot);
+    if (level == OS_SORT_LINK_WHEEL_LEVELS) {
+        return OsSortLinkOverflowMinTick(sortLinkHeader) * OS_CYCLE_PER_TICK;
+    }
+
+    if (level != 0) {
+        return OsSortLinkSlotStartTick(sortLinkHeader, level, slot) * OS_CYCLE_PER_TICK;
+    }
+
+    LOS_DL_LIST_FOR_EACH_ENTRY(sortList, &sortLinkHeader->wheel[0].slot[slot], SortLinkList, sortLinkNode) {
+        if (sortList->responseTime < responseTime) {
+            responseTime = sortList->responseTime;
+        }
+    }
+
+    return responseTime;
+}
+
 STATIC INLINE UINT64 OsGetSortLinkNextExpireTime(SortLinkAttribute *sortHeader, UINT64 startTime)
 {
-    LOS_DL_LIST *head = &sortHeader->sortLink;
-    LOS_DL_LIST *list = head->pstNext;
+    UINT64 responseTime = OsSortLinkFirstResponseTime(sortHeader);
 
-    if (LOS_ListEmpty(head)) {
+    if (responseTime == OS_SORT_LINK_INVALID_TIME) {
         return OS_SCHED_MAX_RESPONSE_TIME - OS_TICK_RESPONSE_PRECISION;
     }
 
-    SortLinkList *listSorted = LOS_DL_LIST_ENTRY(list, SortLinkList, sortLinkNode);
-    if (listSorted->responseTime <= (startTime + OS_TICK_RESPONSE_PRECISION)) {
+    if (responseTime <= (startTime + OS_TICK_RESPONSE_PRECISION)) {
         return startTime + OS_TICK_RESPONSE_PRECISION;
     }
 
-    return listSorted->responseTime;
+    return responseTime;
 }
 
 STATIC Percpu *OsFindIdleCpu(UINT16 *idleCpuID)
@@ -155,7 +357,8 @@ VOID OsAdd2SortLink(SortLinkList *node, UINT64 startTime, UINT32 waitTicks, Sort
     OsAddNode2SortLink(sortLinkHeader, node);
 #ifdef LOSCFG_KERNEL_SMP
     node->cpuid = idleCpu;
-    if (idleCpu != ArchCurrCpuid()) {
+    /* The other cpu only needs to reprogram its tick if the node expires before its next response */
+    if ((idleCpu != ArchCurrCpuid()) && (GET_SORTLIST_VALUE(node) < OsPercpuGetByID(idleCpu)->responseTime)) {
         LOS_MpSchedule(CPUID_TO_AFFI_MASK(idleCpu));
     }
 #endif
@@ -220,13 +423,12 @@ UINT32 OsSortLinkGetTargetExpireTime(const SortLinkList *targetSortList)
 
 UINT32 OsSortLinkGetNextExpireTime(const SortLinkAttribute *sortLinkHeader)
 {
-    LOS_DL_LIST *head = (LOS_DL_LIST *)&sortLinkHeader->sortLink;
+    SortLinkList sortList;
 
-    if (LOS_ListEmpty(head)) {
+    sortList.responseTime = OsSortLinkFirstResponseTime((SortLinkAttribute *)sortLinkHeader);
+    if (sortList.responseTime == OS_SORT_LINK_INVALID_TIME) {
         return 0;
     }
 
-    SortLinkList *listSorted = LOS_DL_LIST_ENTRY(head->pstNext, SortLinkList, sortLinkNode);
-    return OsSortLinkGetTargetExpireTime(listSorted);
+    return OsSortLinkGetTargetExpireTime(&sortList);
 }
-
@@ -37,6 +37,7 @@
 #include "los_memory_pri.h"
 #include "los_vm_page.h"
 #include "los_arch_mmu.h"
+#include "los_vm_filemap.h"
 
 
 UINTPTR g_vmBootMemBase = (UINTPTR)&__bss_end;
@@ -75,6 +76,7 @@ UINT32 OsSysMemInit(VOID)
     OsVmPageStartup();
     g_kHeapInited = TRUE;
     OsInitMappingStartUp();
+    OsVmFileMapInit();
 #else
     g_kHeapInited = TRUE;
 #endif
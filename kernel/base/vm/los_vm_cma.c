@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_vm_phys.h"
+#include "los_vm_filemap.h"
+#include "los_vm_common.h"
+
+#ifdef LOSCFG_KERNEL_CMA
+STATIC LosVmPage *OsVmCmaRangeClaim(LosVmPhysSeg *seg, size_t nPages)
+{
+    size_t segPages = seg->size >> PAGE_SHIFT;
+    size_t align = VM_ORDER_TO_PAGES(min(OsVmPagesToOrder(nPages), VM_LIST_ORDER_MAX - 1));
+    LosVmPage *page = NULL;
+    size_t index;
+
+    for (index = 0; (index + nPages) <= segPages; index += align) {
+        /* Page cache pages are the only movable pages, anonymous pages have no reverse mapping */
+        (VOID)OsFilePagesEvacuate(seg, &seg->pageBase[index], nPages);
+        /* Pages freed by the evacuation sit on the cpu caches first */
+        (VOID)OsVmPcpDrainAll();
+        page = OsVmPhysRangeAlloc(seg, &seg->pageBase[index], nPages);
+        if (page != NULL) {
+            return page;
+        }
+    }
+    return NULL;
+}
+
+LosVmPage *OsVmCmaPagesAlloc(size_t nPages)
+{
+    LosVmPhysSeg *seg = NULL;
+    LosVmPage *page = NULL;
+    INT32 segID;
+
+    for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+        seg = &g_vmPhysSeg[segID];
+        if (!seg->isCma) {
+            continue;
+        }
+
+        page = OsVmPhysSegPagesAlloc(seg, nPages);
+        if (page == NULL) {
+            page = OsVmCmaRangeClaim(seg, nPages);
+        }
+        if (page != NULL) {
+            return page;
+        }
+    }
+    return NULL;
+}
+#endif
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_vm_phys.h"
+#include "los_vm_filemap.h"
+#include "los_vm_common.h"
+#include "los_event.h"
+#include "los_init.h"
+#include "los_task_pri.h"
+#include "los_seq_buf.h"
+#include "securec.h"
+
+#ifdef LOSCFG_KERNEL_VM_COMPACTION
+#define OS_COMPACT_ORDER            4       /* 64KB, the block size the task keeps available */
+#define OS_COMPACT_THRESHOLD        500     /* fragmentation index above which the task compacts */
+#define OS_COMPACT_INDEX_MAX        1000
+#define OS_COMPACT_BLOCKS_MAX       8       /* blocks one segment gets freed up per background round */
+#define OS_COMPACT_INTERVAL         (LOSCFG_BASE_CORE_TICK_PER_SECOND * 10)
+#define OS_COMPACT_EVENT_RUN        0x01
+#define OS_COMPACT_STACK_SIZE       0x1000
+
+typedef struct {
+    UINT32 runs;            /* Compaction passes, direct and background */
+    UINT32 pagesMoved;
+    UINT32 blocksFreed;
+    UINT32 failures;        /* Blocks left behind because a page could not be moved */
+} VmCompactStat;
+
+STATIC VmCompactStat g_vmCompactStat;
+STATIC UINT32 g_vmCompactThreshold = OS_COMPACT_THRESHOLD;
+STATIC Atomic g_vmCompactBusy = 0;
+STATIC EVENT_CB_S g_vmCompactEvent;
+STATIC BOOL g_vmCompactReady = FALSE;
+
+/* Share of the free pages of seg, in thousandths, that can not serve an allocation of the given order */
+UINT32 OsVmFragIndexGet(LosVmPhysSeg *seg, UINT32 order)
+{
+    UINT64 freePages = 0;
+    UINT64 usablePages = 0;
+    UINT64 pages;
+    UINT32 flindex;
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    for (flindex = 0; flindex < VM_LIST_ORDER_MAX; flindex++) {
+        pages = (UINT64)VM_ORDER_TO_PAGES(flindex) * seg->freeList[flindex].listCnt;
+        freePages += pages;
+        if (flindex >= order) {
+            usablePages += pages;
+        }
+    }
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+
+    if (freePages == 0) {
+        return 0;
+    }
+    return (UINT32)(((freePages - usablePages) * OS_COMPACT_INDEX_MAX) / freePages);
+}
+
+/* Returns the page cache pages in the block, or -1 if something that can not move sits in it */
+STATIC INT32 OsVmCompactBlockCost(LosVmPage *start, size_t nPages)
+{
+    LosVmPage *page = NULL;
+    INT32 movable = 0;
+    size_t index;
+
+    for (index = 0; index < nPages;) {
+        page = &start[index];
+        if (page->order < VM_LIST_ORDER_MAX) {
+            index += VM_ORDER_TO_PAGES(page->order);
+            continue;
+        }
+        if (!OsIsPageLRU(page)) {
+            return -1;
+        }
+        movable++;
+        index++;
+    }
+    return movable;
+}
+
+/* Frees up to blocks blocks of the given order by moving out the page cache pages of the cheapest ones */
+STATIC UINT32 OsVmCompactSeg(LosVmPhysSeg *seg, UINT32 order, UINT32 blocks)
+{
+    size_t blockPages = VM_ORDER_TO_PAGES(order);
+    size_t segPages = seg->size >> PAGE_SHIFT;
+    size_t first = (ROUNDUP(seg->start, VM_ORDER_TO_PHYS(order)) - seg->start) >> PAGE_SHIFT;
+    size_t index, best;
+    INT32 cost, bestCost;
+    UINT32 left;
+    UINT32 freed = 0;
+
+    while (freed < blocks) {
+        best = segPages;
+        bestCost = (INT32)blockPages + 1;
+        for (index = first; (index + blockPages) <= segPages; index += blockPages) {
+            cost = OsVmCompactBlockCost(&seg->pageBase[index], blockPages);
+            if ((cost > 0) && (cost < bestCost)) {
+                bestCost = cost;
+                best = index;
+            }
+        }
+        if (best == segPages) {
+            break;
+        }
+
+        left = OsFilePagesEvacuate(seg, &seg->pageBase[best], blockPages);
+        g_vmCompactStat.pagesMoved += (UINT32)bestCost - left;
+        /* The pages moved away sit on the cpu caches until drained */
+        (VOID)OsVmPcpDrainAll();
+        if (left != 0) {
+            g_vmCompactStat.failures++;
+            break;
+        }
+        freed++;
+    }
+
+    g_vmCompactStat.blocksFreed += freed;
+    return freed;
+}
+
+STATIC BOOL OsVmCompactRun(UINT32 order, UINT32 threshold, UINT32 blocks)
+{
+    LosVmPhysSeg *seg = NULL;
+    UINT32 freed = 0;
+    INT32 segID;
+
+    /* One compaction at a time, a second caller would only fight over the same blocks */
+    if (LOS_AtomicCmpXchg32bits(&g_vmCompactBusy, 1, 0)) {
+        return FALSE;
+    }
+
+    g_vmCompactStat.runs++;
+    for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+        seg = &g_vmPhysSeg[segID];
+#ifdef LOSCFG_KERNEL_CMA
+        if (seg->isCma) {
+            continue;
+        }
+#endif
+        if (OsVmFragIndexGet(seg, order) <= threshold) {
+            continue;
+        }
+        freed += OsVmCompactSeg(seg, order, blocks);
+        if (freed >= blocks) {
+            break;
+        }
+    }
+
+    LOS_AtomicSet(&g_vmCompactBusy, 0);
+    return (freed != 0);
+}
+
+BOOL OsVmCompact(UINT32 order)
+{
+    if (order >= VM_LIST_ORDER_MAX) {
+        return FALSE;
+    }
+    return OsVmCompactRun(order, 0, 1);
+}
+
+VOID OsVmCompactWakeup(VOID)
+{
+    if (g_vmCompactReady) {
+        (VOID)LOS_EventWrite(&g_vmCompactEvent, OS_COMPACT_EVENT_RUN);
+    }
+}
+
+UINT32 OsVmCompactThresholdSet(UINT32 threshold)
+{
+    if (threshold > OS_COMPACT_INDEX_MAX) {
+        return LOS_NOK;
+    }
+    g_vmCompactThreshold = threshold;
+    return LOS_OK;
+}
+
+VOID OsVmCompactShow(struct SeqBuf *seqBuf)
+{
+    LosVmPhysSeg *seg = NULL;
+    UINT32 order;
+    INT32 segID;
+
+    (VOID)LosBufPrintf(seqBuf, "fragmentation index by order (0: no free page unusable, %u: all)\n",
+                       OS_COMPACT_INDEX_MAX);
+    for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+        seg = &g_vmPhysSeg[segID];
+        (VOID)LosBufPrintf(seqBuf, "seg %d 0x%08x:", segID, seg->start);
+        for (order = 0; order < VM_LIST_ORDER_MAX; order++) {
+            (VOID)LosBufPrintf(seqBuf, " %4u", OsVmFragIndexGet(seg, order));
+        }
+        (VOID)LosBufPrintf(seqBuf, "\n");
+    }
+
+    (VOID)LosBufPrintf(seqBuf, "threshold    %u (order %u)\n", g_vmCompactThreshold, OS_COMPACT_ORDER);
+    (VOID)LosBufPrintf(seqBuf, "runs         %u\n", g_vmCompactStat.runs);
+    (VOID)LosBufPrintf(seqBuf, "pages moved  %u\n", g_vmCompactStat.pagesMoved);
+    (VOID)LosBufPrintf(seqBuf, "blocks freed %u\n", g_vmCompactStat.blocksFreed);
+    (VOID)LosBufPrintf(seqBuf, "failures     %u\n", g_vmCompactStat.failures);
+}
+
+STATIC VOID OsVmCompactTask(VOID)
+{
+    while (1) {
+        (VOID)LOS_EventRead(&g_vmCompactEvent, OS_COMPACT_EVENT_RUN,
+                            LOS_WAITMODE_OR | LOS_WAITMODE_CLR, OS_COMPACT_INTERVAL);
+        (VOID)OsVmCompactRun(OS_COMPACT_ORDER, g_vmCompactThreshold, OS_COMPACT_BLOCKS_MAX);
+    }
+}
+
+STATIC UINT32 OsVmCompactInit(VOID)
+{
+    UINT32 ret;
+    UINT32 taskID;
+    TSK_INIT_PARAM_S taskInitParam;
+
+    ret = LOS_EventInit(&g_vmCompactEvent);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    (VOID)memset_s((VOID *)(&taskInitParam), sizeof(TSK_INIT_PARAM_S), 0, sizeof(TSK_INIT_PARAM_S));
+    taskInitParam.pfnTaskEntry = (TSK_ENTRY_FUNC)OsVmCompactTask;
+    taskInitParam.uwStackSize = OS_COMPACT_STACK_SIZE;
+    taskInitParam.pcName = "CompactTask";
+    taskInitParam.usTaskPrio = OS_TASK_PRIORITY_LOWEST;
+    ret = LOS_TaskCreate(&taskID, &taskInitParam);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+    OS_TCB_FROM_TID(taskID)->taskStatus |= OS_TASK_FLAG_NO_DELETE;
+
+    g_vmCompactReady = TRUE;
+    return LOS_OK;
+}
+
+LOS_MODULE_INIT(OsVmCompactInit, LOS_INIT_LEVEL_KMOD_TASK);
+#endif
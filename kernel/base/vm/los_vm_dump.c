@@ -482,6 +482,7 @@ UINT32 OsVmPhySegPagesGet(LosVmPhysSeg *seg)
         segFreePages += ((1 << flindex) * seg->freeList[flindex].listCnt);
     }
     LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+    segFreePages += OsVmPcpPagesGet(seg);
 
     return segFreePages;
 }
@@ -506,6 +507,11 @@ VOID OsVmPhysDump(VOID)
             PRINTK(" --------      -------      ----------  ---------  \n");
 #endif
             PRINTK(" 0x%08x    0x%08x   0x%08x   %8u  \n", seg, seg->start, seg->size, segFreePages);
+#ifdef LOSCFG_KERNEL_CMA
+            if (seg->isCma) {
+                PRINTK(" cma area, movable pages only\n");
+            }
+#endif
             totalFreePages += segFreePages;
             totalPages += (seg->size >> PAGE_SHIFT);
 
@@ -517,6 +523,7 @@ VOID OsVmPhysDump(VOID)
             for (flindex = 0; flindex < VM_LIST_ORDER_MAX; flindex++) {
                 PRINTK("order = %d, free_count = %d\n", flindex, listCount[flindex]);
             }
+            PRINTK("cpu cached      %u\n", OsVmPcpPagesGet(seg));
 
             PRINTK("active   anon   %d\n", seg->lruSize[VM_LRU_ACTIVE_ANON]);
             PRINTK("inactive anon   %d\n", seg->lruSize[VM_LRU_INACTIVE_ANON]);
@@ -131,6 +131,9 @@ STATIC STATUS_T OsDoReadFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
             (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
             return LOS_ERRNO_VM_NO_MEMORY;
         }
+#ifdef LOSCFG_KERNEL_VM_FAULT_AROUND
+        OsVmmFileFaultAround(region, vmPgFault);
+#endif
 
         (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
         return LOS_OK;
@@ -403,14 +406,13 @@ STATUS_T OsVmPageFaultHandler(VADDR_T vaddr, UINT32 flags, ExcContext *frame)
     }
 #endif
 
-    newPage = LOS_PhysPageAlloc();
+    newPage = LOS_PhysPageAllocZeroed();
     if (newPage == NULL) {
         status = LOS_ERRNO_VM_NO_MEMORY;
         goto CHECK_FAILED;
     }
 
     newPaddr = VM_PAGE_TO_PHYS(newPage);
-    (VOID)memset_s(OsVmPageToVaddr(newPage), PAGE_SIZE, 0, PAGE_SIZE);
     status = LOS_ArchMmuQuery(&space->archMmu, vaddr, &oldPaddr, NULL);
     if (status >= 0) {
         LOS_ArchMmuUnmap(&space->archMmu, vaddr, 1);
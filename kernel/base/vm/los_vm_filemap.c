@@ -41,6 +41,8 @@
 #include "los_vm_fault.h"
 #include "los_process_pri.h"
 #include "los_vm_lock.h"
+#include "los_slab_pri.h"
+#include "los_vm_radix.h"
 #ifdef LOSCFG_FS_VFS
 #include "vnode.h"
 #endif
@@ -69,34 +71,62 @@ VOID ResetPageCacheHitInfo(int *try, int *hit)
 
 #ifdef LOSCFG_KERNEL_VM
 
-STATIC VOID OsPageCacheAdd(LosFilePage *page, struct page_mapping *mapping, VM_OFFSET_T pgoff)
-{
-    LosFilePage *fpage = NULL;
+LITE_OS_SEC_BSS STATIC SlabCache *g_filePageCache = NULL;
+LITE_OS_SEC_BSS STATIC SlabCache *g_mapInfoCache = NULL;
 
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        if (fpage->pgoff > pgoff) {
-            LOS_ListTailInsert(&fpage->node, &page->node);
-            goto done_add;
-        }
+VOID OsVmFileMapInit(VOID)
+{
+    g_filePageCache = OsSlabCacheCreate("file_page", sizeof(LosFilePage), NULL);
+    g_mapInfoCache = OsSlabCacheCreate("map_info", sizeof(LosMapInfo), NULL);
+    OsVmRadixInit();
+    if ((g_filePageCache == NULL) || (g_mapInfoCache == NULL)) {
+        VM_ERR("create page cache slab failed");
     }
+}
+
+VOID OsMapInfoFree(LosMapInfo *info)
+{
+    OsSlabFree(g_mapInfoCache, info);
+}
 
-    LOS_ListTailInsert(&mapping->page_list, &page->node);
+STATIC INLINE VmRadixTree *OsPageCacheTree(struct page_mapping *mapping)
+{
+    return &((struct Vnode *)mapping->host)->pageTree;
+}
+
+STATIC STATUS_T OsPageCacheAdd(LosFilePage *page, struct page_mapping *mapping, VM_OFFSET_T pgoff)
+{
+    STATUS_T ret;
 
-done_add:
+    ret = OsVmRadixInsert(OsPageCacheTree(mapping), (UINT32)pgoff, page);
+    if (ret != LOS_OK) {
+        return ret;
+    }
     mapping->nrpages++;
+    return LOS_OK;
 }
 
-VOID OsAddToPageacheLru(LosFilePage *page, struct page_mapping *mapping, VM_OFFSET_T pgoff)
+STATUS_T OsAddToPageacheLru(LosFilePage *page, struct page_mapping *mapping, VM_OFFSET_T pgoff)
 {
-    OsPageCacheAdd(page, mapping, pgoff);
+    STATUS_T ret;
+
+    ret = OsPageCacheAdd(page, mapping, pgoff);
+    if (ret != LOS_OK) {
+        return ret;
+    }
     OsLruCacheAdd(page, VM_LRU_ACTIVE_FILE);
+    return LOS_OK;
 }
 
 VOID OsPageCacheDel(LosFilePage *fpage)
 {
-    /* delete from file cache list */
-    LOS_ListDelete(&fpage->node);
-    fpage->mapping->nrpages--;
+    VmRadixTree *tree = OsPageCacheTree(fpage->mapping);
+
+    /* delete from file cache index, a page whose read failed never got there */
+    if (OsVmRadixLookup(tree, (UINT32)fpage->pgoff) == fpage) {
+        (VOID)OsVmRadixDelete(tree, (UINT32)fpage->pgoff);
+        fpage->mapping->nrpages--;
+    }
 
     /* unmap and remove map info */
     if (OsIsPageMapped(fpage)) {
@@ -105,14 +135,14 @@ VOID OsPageCacheDel(LosFilePage *fpage)
 
     LOS_PhysPageFree(fpage->vmPage);
 
-    LOS_MemFree(m_aucSysMem0, fpage);
+    OsSlabFree(g_filePageCache, fpage);
 }
 
 VOID OsAddMapInfo(LosFilePage *page, LosArchMmu *archMmu, VADDR_T vaddr)
 {
     LosMapInfo *info = NULL;
 
-    info = (LosMapInfo *)LOS_MemAlloc(m_aucSysMem0, sizeof(LosMapInfo));
+    info = (LosMapInfo *)OsSlabAlloc(g_mapInfoCache);
     if (info == NULL) {
         VM_ERR("OsAddMapInfo alloc memory failed!");
         return;
@@ -216,6 +246,7 @@ VOID OsVmmFileRemove(LosVmMapRegion *region, LosArchMmu *archMmu, VM_OFFSET_T pg
 
 VOID OsMarkPageDirty(LosFilePage *fpage, LosVmMapRegion *region, INT32 off, INT32 len)
 {
+    OsVmRadixTagSet(OsPageCacheTree(fpage->mapping), (UINT32)fpage->pgoff, VM_RADIX_TAG_DIRTY);
     if (region != NULL) {
         OsSetPageDirty(fpage->vmPage);
         fpage->dirtyOff = off;
@@ -295,13 +326,14 @@ LosFilePage *OsDumpDirtyPage(LosFilePage *oldFPage)
 {
     LosFilePage *newFPage = NULL;
 
-    newFPage = (LosFilePage *)LOS_MemAlloc(m_aucSysMem0, sizeof(LosFilePage));
+    newFPage = (LosFilePage *)OsSlabAlloc(g_filePageCache);
     if (newFPage == NULL) {
         VM_ERR("Failed to allocate for temp page!");
         return NULL;
     }
 
     OsCleanPageDirty(oldFPage->vmPage);
+    OsVmRadixTagClear(OsPageCacheTree(oldFPage->mapping), (UINT32)oldFPage->pgoff, VM_RADIX_TAG_DIRTY);
     (VOID)memcpy_s(newFPage, sizeof(LosFilePage), oldFPage, sizeof(LosFilePage));
 
     return newFPage;
@@ -313,7 +345,7 @@ VOID OsDoFlushDirtyPage(LosFilePage *fpage)
         return;
     }
     (VOID)OsFlushDirtyPage(fpage);
-    LOS_MemFree(m_aucSysMem0, fpage);
+    OsSlabFree(g_filePageCache, fpage);
 }
 
 STATIC VOID OsReleaseFpage(struct page_mapping *mapping, LosFilePage *fpage)
@@ -350,6 +382,7 @@ VOID OsDelMapInfo(LosVmMapRegion *region, LosVmPgFault *vmf, BOOL cleanDirty)
 
     if (cleanDirty) {
         OsCleanPageDirty(fpage->vmPage);
+        OsVmRadixTagClear(OsPageCacheTree(mapping), (UINT32)fpage->pgoff, VM_RADIX_TAG_DIRTY);
     }
     info = OsGetMapInfo(fpage, &region->space->archMmu, (vaddr_t)vmf->vaddr);
     if (info != NULL) {
@@ -357,7 +390,7 @@ VOID OsDelMapInfo(LosVmMapRegion *region, LosVmPgFault *vmf, BOOL cleanDirty)
         LOS_ListDelete(&info->node);
         LOS_AtomicDec(&fpage->vmPage->refCounts);
         LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
-        LOS_MemFree(m_aucSysMem0, info);
+        OsMapInfoFree(info);
         return;
     }
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
@@ -381,6 +414,10 @@ INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
     vnode = region->unTypeData.rf.vnode;
     mapping = &vnode->mapping;
 
+#ifdef LOSCFG_KERNEL_VM_READAHEAD
+    OsVmReadahead(region, vmf->pgoff);
+#endif
+
     /* get or create a new cache node */
     LOS_SpinLockSave(&mapping->list_lock, &intSave);
     fpage = OsFindGetEntry(mapping, vmf->pgoff);
@@ -410,7 +447,12 @@ INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
             return LOS_NOK;
         }
         LOS_SpinLockSave(&mapping->list_lock, &intSave);
-        OsAddToPageacheLru(fpage, mapping, vmf->pgoff);
+        if (OsAddToPageacheLru(fpage, mapping, vmf->pgoff) != LOS_OK) {
+            LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+            VM_ERR("Failed to index page cache!");
+            OsReleaseFpage(mapping, fpage);
+            return LOS_NOK;
+        }
         LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
     }
 
@@ -431,11 +473,219 @@ INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
     return LOS_OK;
 }
 
+#ifdef LOSCFG_KERNEL_VM_READAHEAD
+/* Reads a run of pages adjacent in the file with one call into the file system, returns the pages filled */
+STATIC UINT32 OsPageCacheRunRead(struct Vnode *vnode, LosFilePage **fpages, UINT32 count)
+{
+    CHAR *buffers[VM_READAHEAD_PAGES_MAX];
+    ssize_t ret;
+    UINT32 i;
+
+    for (i = 0; i < count; i++) {
+        buffers[i] = (CHAR *)OsVmPageToVaddr(fpages[i]->vmPage);
+    }
+
+    if (vnode->vop->ReadPages != NULL) {
+        ret = vnode->vop->ReadPages(vnode, buffers, count, fpages[0]->pgoff << PAGE_SHIFT);
+        if (ret <= 0) {
+            return 0;
+        }
+        return MIN2(count, ROUNDUP((UINT32)ret, PAGE_SIZE) >> PAGE_SHIFT);
+    }
+
+    if (vnode->vop->ReadPage == NULL) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        if (vnode->vop->ReadPage(vnode, buffers[i], fpages[i]->pgoff << PAGE_SHIFT) <= 0) {
+            break;
+        }
+    }
+    return i;
+}
+
+/*
+ * Brings the pages of [start, start + nPages) missing from the page cache in, the page at marker gets the
+ * readahead flag. Caller need mux_lock, so nobody else fills the same pages meanwhile.
+ */
+UINT32 OsPageCacheReadPages(struct page_mapping *mapping, VM_OFFSET_T start, UINT32 nPages, VM_OFFSET_T marker)
+{
+    LosFilePage *fpages[VM_READAHEAD_PAGES_MAX];
+    struct Vnode *vnode = mapping->host;
+    VM_OFFSET_T end = start + MIN2(nPages, VM_READAHEAD_PAGES_MAX);
+    VM_OFFSET_T pgoff = start;
+    UINT32 filled = 0;
+    UINT32 intSave;
+    UINT32 count;
+    UINT32 done;
+    UINT32 i;
+
+    while (pgoff < end) {
+        /* find the next run of pages not cached yet */
+        count = 0;
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        while ((pgoff < end) && (OsFindGetEntry(mapping, pgoff) != NULL)) {
+            pgoff++;
+        }
+        while (((pgoff + count) < end) && (OsFindGetEntry(mapping, pgoff + count) == NULL)) {
+            count++;
+        }
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+        for (i = 0; i < count; i++) {
+            fpages[i] = OsPageCacheAlloc(mapping, pgoff + i);
+            if (fpages[i] == NULL) {
+                count = i;
+                break;
+            }
+        }
+        if (count == 0) {
+            break;
+        }
+
+        done = OsPageCacheRunRead(vnode, fpages, count);
+
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        for (i = 0; i < done; i++) {
+            if (fpages[i]->pgoff == marker) {
+                OsSetPageReadahead(fpages[i]->vmPage);
+            }
+            if (OsAddToPageacheLru(fpages[i], mapping, fpages[i]->pgoff) == LOS_OK) {
+                fpages[i] = NULL;
+                filled++;
+            }
+        }
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+        for (i = 0; i < count; i++) {
+            if (fpages[i] != NULL) {
+                OsReleaseFpage(mapping, fpages[i]);
+            }
+        }
+        if (done < count) {
+            break; /* end of file or read error, the faulting page reports the latter itself */
+        }
+        pgoff += count;
+    }
+
+    return filled;
+}
+#endif
+
+#ifdef LOSCFG_KERNEL_VM_FAULT_AROUND
+STATIC UINT32 OsFaultAroundPagesGet(LosVmMapRegion *region, VADDR_T start, UINT32 count, UINT32 holes,
+                                    LosFilePage **fpages)
+{
+    UINT32 i;
+    UINT32 nr = 0;
+    UINT32 intSave;
+    VADDR_T vaddr;
+    LosFilePage *fpage = NULL;
+    LosArchMmu *archMmu = &region->space->archMmu;
+    struct page_mapping *mapping = &region->unTypeData.rf.vnode->mapping;
+
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    for (i = 0; i < count; i++) {
+        fpages[i] = NULL;
+        if (!(holes & (1U << i))) {
+            continue;
+        }
+        vaddr = start + (i << PAGE_SHIFT);
+        fpage = OsFindGetEntry(mapping, ((vaddr - region->range.base) >> PAGE_SHIFT) + region->pgOff);
+        /* readahead markers are left to fault, that is what starts the next window */
+        if ((fpage == NULL) || OsIsPageLocked(fpage->vmPage) || OsIsPageReadahead(fpage->vmPage)) {
+            continue;
+        }
+        /* locked until mapped, so neither shrink nor migration takes it meanwhile */
+        OsSetPageLocked(fpage->vmPage);
+        OsAddMapInfo(fpage, archMmu, vaddr);
+        fpage->flags = region->regionFlags;
+        LOS_AtomicInc(&fpage->vmPage->refCounts);
+        fpages[i] = fpage;
+        nr++;
+    }
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+    return nr;
+}
+
+/*
+ * Map the cached neighbours of a read faulted page, within an aligned window clipped to the region.
+ * Pages not yet in the page cache are left to their own fault, nothing is read from the file here.
+ */
+VOID OsVmmFileFaultAround(LosVmMapRegion *region, LosVmPgFault *vmf)
+{
+    UINT32 i;
+    UINT32 count;
+    UINT32 intSave;
+    UINT32 holes = 0;
+    VADDR_T vaddr;
+    VADDR_T start;
+    VADDR_T end;
+    LosMapInfo *info = NULL;
+    LosFilePage *fpages[VM_FAULT_AROUND_PAGES];
+    LosArchMmu *archMmu = NULL;
+    struct page_mapping *mapping = NULL;
+    UINT32 mmuFlags = region->regionFlags & (~VM_MAP_REGION_FLAG_PERM_WRITE);
+
+    if (!LOS_IsRegionFileValid(region) || (region->unTypeData.rf.vnode == NULL) || (vmf == NULL)) {
+        return;
+    }
+    archMmu = &region->space->archMmu;
+    mapping = &region->unTypeData.rf.vnode->mapping;
+
+    start = ROUNDDOWN((VADDR_T)vmf->vaddr, VM_FAULT_AROUND_PAGES << PAGE_SHIFT);
+    end = start + ((VM_FAULT_AROUND_PAGES - 1) << PAGE_SHIFT);
+    start = (start < region->range.base) ? region->range.base : start;
+    end = (end > LOS_RegionEndAddr(region)) ? ROUNDDOWN(LOS_RegionEndAddr(region), PAGE_SIZE) : end;
+    count = ((end - start) >> PAGE_SHIFT) + 1;
+
+    for (i = 0; i < count; i++) {
+        vaddr = start + (i << PAGE_SHIFT);
+        if ((vaddr != (VADDR_T)vmf->vaddr) && (LOS_ArchMmuQuery(archMmu, vaddr, NULL, NULL) != LOS_OK)) {
+            holes |= 1U << i;
+        }
+    }
+    if ((holes == 0) || (OsFaultAroundPagesGet(region, start, count, holes, fpages) == 0)) {
+        return;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (fpages[i] == NULL) {
+            continue;
+        }
+        vaddr = start + (i << PAGE_SHIFT);
+        if (LOS_ArchMmuMap(archMmu, vaddr, VM_PAGE_TO_PHYS(fpages[i]->vmPage), 1, mmuFlags) >= 0) {
+            OsCleanPageLocked(fpages[i]->vmPage);
+            continue;
+        }
+
+        /* out of page table memory, leave this page to its own fault */
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        info = OsGetMapInfo(fpages[i], archMmu, vaddr);
+        if (info != NULL) {
+            fpages[i]->n_maps--;
+            LOS_ListDelete(&info->node);
+            LOS_AtomicDec(&fpages[i]->vmPage->refCounts);
+        }
+        OsCleanPageLocked(fpages[i]->vmPage);
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+        if (info != NULL) {
+            OsMapInfoFree(info);
+        }
+    }
+}
+#endif
+
 VOID OsFileCacheFlush(struct page_mapping *mapping)
 {
     UINT32 intSave;
     UINT32 lruLock;
+    UINT32 i;
+    UINT32 nr;
+    VM_OFFSET_T pgoff = 0;
     LOS_DL_LIST_HEAD(dirtyList);
+    LosFilePage *fpages[VM_FILE_PAGE_BATCH];
     LosFilePage *ftemp = NULL;
     LosFilePage *fpage = NULL;
 
@@ -443,15 +693,26 @@ VOID OsFileCacheFlush(struct page_mapping *mapping)
         return;
     }
     LOS_SpinLockSave(&mapping->list_lock, &intSave);
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        LOS_SpinLockSave(&fpage->physSeg->lruLock, &lruLock);
-        if (OsIsPageDirty(fpage->vmPage)) {
-            ftemp = OsDumpDirtyPage(fpage);
-            if (ftemp != NULL) {
-                LOS_ListTailInsert(&dirtyList, &ftemp->node);
+    /* only the subtrees tagged dirty are walked, clean pages are never visited */
+    while ((nr = OsVmRadixGangLookupTag(OsPageCacheTree(mapping), (VOID **)fpages, pgoff,
+                                        VM_FILE_PAGE_BATCH, VM_RADIX_TAG_DIRTY)) > 0) {
+        for (i = 0; i < nr; i++) {
+            fpage = fpages[i];
+            LOS_SpinLockSave(&fpage->physSeg->lruLock, &lruLock);
+            if (OsIsPageDirty(fpage->vmPage)) {
+                ftemp = OsDumpDirtyPage(fpage);
+                if (ftemp != NULL) {
+                    LOS_ListTailInsert(&dirtyList, &ftemp->node);
+                }
+            } else {
+                OsVmRadixTagClear(OsPageCacheTree(mapping), (UINT32)fpage->pgoff, VM_RADIX_TAG_DIRTY);
             }
+            LOS_SpinUnlockRestore(&fpage->physSeg->lruLock, lruLock);
+        }
+        pgoff = fpages[nr - 1]->pgoff + 1;
+        if (pgoff == 0) {
+            break;
         }
-        LOS_SpinUnlockRestore(&fpage->physSeg->lruLock, lruLock);
     }
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
 
@@ -466,23 +727,30 @@ VOID OsFileCacheRemove(struct page_mapping *mapping)
     UINT32 lruSave;
     SPIN_LOCK_S *lruLock = NULL;
     LOS_DL_LIST_HEAD(dirtyList);
+    LosFilePage *fpages[VM_FILE_PAGE_BATCH];
     LosFilePage *ftemp = NULL;
     LosFilePage *fpage = NULL;
     LosFilePage *fnext = NULL;
+    UINT32 i;
+    UINT32 nr;
 
     LOS_SpinLockSave(&mapping->list_lock, &intSave);
-    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(fpage, fnext, &mapping->page_list, LosFilePage, node) {
-        lruLock = &fpage->physSeg->lruLock;
-        LOS_SpinLockSave(lruLock, &lruSave);
-        if (OsIsPageDirty(fpage->vmPage)) {
-            ftemp = OsDumpDirtyPage(fpage);
-            if (ftemp != NULL) {
-                LOS_ListTailInsert(&dirtyList, &ftemp->node);
+    /* every page found is deleted from the index, so each batch starts over from the lowest pgoff */
+    while ((nr = OsFindGetEntries(mapping, 0, fpages, VM_FILE_PAGE_BATCH)) > 0) {
+        for (i = 0; i < nr; i++) {
+            fpage = fpages[i];
+            lruLock = &fpage->physSeg->lruLock;
+            LOS_SpinLockSave(lruLock, &lruSave);
+            if (OsIsPageDirty(fpage->vmPage)) {
+                ftemp = OsDumpDirtyPage(fpage);
+                if (ftemp != NULL) {
+                    LOS_ListTailInsert(&dirtyList, &ftemp->node);
+                }
             }
-        }
 
-        OsDeletePageCacheLru(fpage);
-        LOS_SpinUnlockRestore(lruLock, lruSave);
+            OsDeletePageCacheLru(fpage);
+            LOS_SpinUnlockRestore(lruLock, lruSave);
+        }
     }
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
 
@@ -540,19 +808,13 @@ STATUS_T OsNamedMMap(struct file *filep, LosVmMapRegion *region)
 
 LosFilePage *OsFindGetEntry(struct page_mapping *mapping, VM_OFFSET_T pgoff)
 {
-    LosFilePage *fpage = NULL;
-
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        if (fpage->pgoff == pgoff) {
-            return fpage;
-        }
-
-        if (fpage->pgoff > pgoff) {
-            break;
-        }
-    }
+    return (LosFilePage *)OsVmRadixLookup(OsPageCacheTree(mapping), (UINT32)pgoff);
+}
 
-    return NULL;
+/* Collects up to maxPages cached pages from first on in pgoff order, caller need list_lock */
+UINT32 OsFindGetEntries(struct page_mapping *mapping, VM_OFFSET_T first, LosFilePage **fpages, UINT32 maxPages)
+{
+    return OsVmRadixGangLookup(OsPageCacheTree(mapping), (VOID **)fpages, (UINT32)first, maxPages);
 }
 
 /* need mutex & change memory to dma zone. */
@@ -563,11 +825,12 @@ LosFilePage *OsPageCacheAlloc(struct page_mapping *mapping, VM_OFFSET_T pgoff)
     LosVmPage *vmPage = NULL;
     LosFilePage *fpage = NULL;
 
-    vmPage = LOS_PhysPageAlloc();
+    vmPage = LOS_PhysPageAllocMovable();
     if (vmPage == NULL) {
         VM_ERR("alloc vm page failed");
         return NULL;
     }
+    OsCleanPageReadahead(vmPage);
     physSeg = OsVmPhysSegGet(vmPage);
     kvaddr = OsVmPageToVaddr(vmPage);
     if ((physSeg == NULL) || (kvaddr == NULL)) {
@@ -576,7 +839,7 @@ LosFilePage *OsPageCacheAlloc(struct page_mapping *mapping, VM_OFFSET_T pgoff)
         return NULL;
     }
 
-    fpage = (LosFilePage *)LOS_MemAlloc(m_aucSysMem0, sizeof(LosFilePage));
+    fpage = (LosFilePage *)OsSlabAlloc(g_filePageCache);
     if (fpage == NULL) {
         LOS_PhysPageFree(vmPage);
         VM_ERR("Failed to allocate for page!");
@@ -595,7 +858,6 @@ LosFilePage *OsPageCacheAlloc(struct page_mapping *mapping, VM_OFFSET_T pgoff)
     fpage->vmPage = vmPage;
     fpage->mapping = mapping;
     fpage->pgoff = pgoff;
-    (VOID)memset_s(kvaddr, PAGE_SIZE, 0, PAGE_SIZE);
 
     return fpage;
 }
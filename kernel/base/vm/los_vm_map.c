@@ -241,6 +241,38 @@ STATIC BOOL OsVmSpaceParamCheck(LosVmSpace *vmSpace)
     return TRUE;
 }
 
+typedef struct {
+    LosVmMapRegion *oldRegion;
+    LosVmMapRegion *newRegion;
+    LosVmSpace *newVmSpace;
+} VmCloneArg;
+
+STATIC VOID OsVmSpaceClonePage(VADDR_T vaddr, PADDR_T paddr, VOID *arg)
+{
+    VmCloneArg *clone = (VmCloneArg *)arg;
+    LosVmPage *page = LOS_VmPageGet(paddr);
+
+    if (page != NULL) {
+        LOS_AtomicInc(&page->refCounts);
+    }
+
+#ifdef LOSCFG_FS_VFS
+    if (LOS_IsRegionFileValid(clone->oldRegion)) {
+        struct page_mapping *mapping = &clone->oldRegion->unTypeData.rf.vnode->mapping;
+        LosFilePage *fpage = NULL;
+        UINT32 intSave;
+
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        fpage = OsFindGetEntry(mapping, clone->newRegion->pgOff +
+                               ((vaddr - clone->newRegion->range.base) >> PAGE_SHIFT));
+        if ((fpage != NULL) && (fpage->vmPage == page)) { /* cow page no need map */
+            OsAddMapInfo(fpage, &clone->newVmSpace->archMmu, vaddr);
+        }
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+    }
+#endif
+}
+
 STATUS_T LOS_VmSpaceClone(LosVmSpace *oldVmSpace, LosVmSpace *newVmSpace)
 {
     LosVmMapRegion *oldRegion = NULL;
@@ -248,13 +280,8 @@ STATUS_T LOS_VmSpaceClone(LosVmSpace *oldVmSpace, LosVmSpace *newVmSpace)
     LosRbNode *pstRbNode = NULL;
     LosRbNode *pstRbNodeNext = NULL;
     STATUS_T ret = LOS_OK;
-    UINT32 numPages;
-    PADDR_T paddr;
-    VADDR_T vaddr;
-    UINT32 intSave;
-    LosVmPage *page = NULL;
-    UINT32 flags;
-    UINT32 i;
+    VmCloneArg clone;
+    STATUS_T status;
 
     if ((OsVmSpaceParamCheck(oldVmSpace) == FALSE) || (OsVmSpaceParamCheck(newVmSpace) == FALSE)) {
         return LOS_ERRNO_VM_INVALID_ARGS;
@@ -289,36 +316,20 @@ STATUS_T LOS_VmSpaceClone(LosVmSpace *oldVmSpace, LosVmSpace *newVmSpace)
             newVmSpace->heap = newRegion;
         }
 
-        numPages = newRegion->range.size >> PAGE_SHIFT;
-        for (i = 0; i < numPages; i++) {
-            vaddr = newRegion->range.base + (i << PAGE_SHIFT);
-            if (LOS_ArchMmuQuery(&oldVmSpace->archMmu, vaddr, &paddr, &flags) != LOS_OK) {
-                continue;
-            }
-
-            page = LOS_VmPageGet(paddr);
-            if (page != NULL) {
-                LOS_AtomicInc(&page->refCounts);
-            }
-            if (flags & VM_MAP_REGION_FLAG_PERM_WRITE) {
-                LOS_ArchMmuUnmap(&oldVmSpace->archMmu, vaddr, 1);
-                LOS_ArchMmuMap(&oldVmSpace->archMmu, vaddr, paddr, 1, flags & ~VM_MAP_REGION_FLAG_PERM_WRITE);
-            }
-            LOS_ArchMmuMap(&newVmSpace->archMmu, vaddr, paddr, 1, flags & ~VM_MAP_REGION_FLAG_PERM_WRITE);
-
-#ifdef LOSCFG_FS_VFS
-            if (LOS_IsRegionFileValid(oldRegion)) {
-                LosFilePage *fpage = NULL;
-                LOS_SpinLockSave(&oldRegion->unTypeData.rf.vnode->mapping.list_lock, &intSave);
-                fpage = OsFindGetEntry(&oldRegion->unTypeData.rf.vnode->mapping, newRegion->pgOff + i);
-                if ((fpage != NULL) && (fpage->vmPage == page)) { /* cow page no need map */
-                    OsAddMapInfo(fpage, &newVmSpace->archMmu, vaddr);
-                }
-                LOS_SpinUnlockRestore(&oldRegion->unTypeData.rf.vnode->mapping.list_lock, intSave);
-            }
-#endif
+        /* share the whole region table by table, both sides are left read only for cow */
+        clone.oldRegion = oldRegion;
+        clone.newRegion = newRegion;
+        clone.newVmSpace = newVmSpace;
+        status = LOS_ArchMmuCopyRange(&oldVmSpace->archMmu, &newVmSpace->archMmu, newRegion->range.base,
+                                      newRegion->range.size >> PAGE_SHIFT, OsVmSpaceClonePage, &clone);
+        if (status < 0) {
+            VM_ERR("copy page table failed, status: %d", status);
+            ret = status;
+            break;
         }
     RB_SCAN_SAFE_END(&oldVmSpace->regionRbTree, pstRbNode, pstRbNodeNext)
+    /* drop the writable parent tlb entries of all regions at once, also after a partial copy */
+    LOS_ArchMmuInvalidateAsid(&oldVmSpace->archMmu);
     (VOID)LOS_MuxRelease(&oldVmSpace->regionMux);
     return ret;
 }
@@ -1070,6 +1081,115 @@ DONE:
     (VOID)LOS_MuxRelease(&space->regionMux);
 }
 
+STATIC BOOL OsVmallocRegionCanExpand(LosVmSpace *space, LosVmMapRegion *region, size_t size)
+{
+    LosVmMapRegion *nextRegion = (LosVmMapRegion *)LOS_RbSuccessorNode(&space->regionRbTree, &region->rbNode);
+    VADDR_T end = region->range.base + size;
+
+    if (end < region->range.base) {
+        return FALSE;
+    }
+
+    if (nextRegion != NULL) {
+        return (end <= nextRegion->range.base);
+    }
+
+    return ((end - 1) <= (space->base + space->size - 1));
+}
+
+/*
+ * Pages already mapped are never copied: the region grows in place when the range behind it
+ * is free, otherwise the page table entries move to a larger region.
+ */
+VOID *LOS_VRealloc(VOID *addr, size_t size)
+{
+    LosVmSpace *space = &g_vMallocSpace;
+    LosVmMapRegion *region = NULL;
+    LosVmMapRegion *newRegion = NULL;
+    LosVmPage *vmPage = NULL;
+    VOID *newAddr = NULL;
+    size_t oldSize;
+    size_t sizeCount;
+    VADDR_T va;
+
+    if (addr == NULL) {
+        return LOS_VMalloc(size);
+    }
+
+    if (size == 0) {
+        LOS_VFree(addr);
+        return NULL;
+    }
+
+    size = LOS_Align(size, PAGE_SIZE);
+    if ((size == 0) || (size > space->size)) {
+        return NULL;
+    }
+
+    LOS_DL_LIST_HEAD(pageList);
+    (VOID)LOS_MuxAcquire(&space->regionMux);
+
+    region = LOS_RegionFind(space, (VADDR_T)(UINTPTR)addr);
+    if ((region == NULL) || (region->range.base != (VADDR_T)(UINTPTR)addr)) {
+        VM_ERR("find region failed");
+        goto DONE;
+    }
+
+    oldSize = region->range.size;
+    if (size <= oldSize) {
+        if (size < oldSize) {
+            OsAnonPagesRemove(&space->archMmu, region->range.base + size, (oldSize - size) >> PAGE_SHIFT);
+            region->range.size = size;
+        }
+        newAddr = addr;
+        goto DONE;
+    }
+
+    sizeCount = (size - oldSize) >> PAGE_SHIFT;
+    if (LOS_PhysPagesAlloc(sizeCount, &pageList) < sizeCount) {
+        VM_ERR("failed to allocate enough pages (ask %zu)", sizeCount);
+        goto DONE;
+    }
+
+    if (OsVmallocRegionCanExpand(space, region, size)) {
+        region->range.size = size;
+        newRegion = region;
+    } else {
+        newRegion = LOS_RegionAlloc(space, 0, size, region->regionFlags, 0);
+        if (newRegion == NULL) {
+            VM_ERR("alloc region failed, size = %x", size);
+            goto DONE;
+        }
+
+        if (LOS_ArchMmuMove(&space->archMmu, region->range.base, newRegion->range.base,
+                            oldSize >> PAGE_SHIFT, region->regionFlags) != LOS_OK) {
+            VM_ERR("move pages of %#x failed", region->range.base);
+            (VOID)LOS_ArchMmuMove(&space->archMmu, newRegion->range.base, region->range.base,
+                                  oldSize >> PAGE_SHIFT, region->regionFlags);
+            (VOID)LOS_RegionFree(space, newRegion);
+            goto DONE;
+        }
+
+        /* nothing is mapped in the old region any more, freeing it keeps the pages */
+        (VOID)LOS_RegionFree(space, region);
+    }
+
+    va = newRegion->range.base + oldSize;
+    while ((vmPage = LOS_ListRemoveHeadType(&pageList, LosVmPage, node))) {
+        LOS_AtomicInc(&vmPage->refCounts);
+        if (LOS_ArchMmuMap(&space->archMmu, va, vmPage->physAddr, 1, newRegion->regionFlags) != 1) {
+            VM_ERR("LOS_ArchMmuMap failed!");
+        }
+        va += PAGE_SIZE;
+    }
+    newAddr = (VOID *)(UINTPTR)newRegion->range.base;
+
+DONE:
+    (VOID)LOS_PhysPagesFree(&pageList);
+    (VOID)LOS_MuxRelease(&space->regionMux);
+    return newAddr;
+}
+
 LosMux *OsGVmSpaceMuxGet(VOID)
 {
     return &g_vmSpaceListMux;
@@ -1146,12 +1266,17 @@ VOID *LOS_KernelRealloc(VOID *ptr, UINT32 size)
                 VM_ERR("page of ptr(%#x) is null", ptr);
                 return NULL;
             }
+            /* Take or give back the pages behind the block before falling back to a copy */
+            if (OsMemLargeAlloc(size) &&
+                (LOS_PhysPagesResizeContiguous(ptr, ROUNDUP(size, PAGE_SIZE) >> PAGE_SHIFT) == LOS_OK)) {
+                return ptr;
+            }
             tmpPtr = LOS_KernelMalloc(size);
             if (tmpPtr == NULL) {
                 VM_ERR("alloc memory failed");
                 return NULL;
             }
-            ret = memcpy_s(tmpPtr, size, ptr, page->nPages << PAGE_SHIFT);
+            ret = memcpy_s(tmpPtr, size, ptr, min(size, page->nPages << PAGE_SHIFT));
             if (ret != EOK) {
                 LOS_KernelFree(tmpPtr);
                 VM_ERR("KernelRealloc memcpy error");
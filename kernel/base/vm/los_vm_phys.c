@@ -35,6 +35,7 @@
 #include "los_vm_map.h"
 #include "los_vm_dump.h"
 #include "los_process_pri.h"
+#include "los_hwi.h"
 
 
 #ifdef LOSCFG_KERNEL_VM
@@ -89,6 +90,35 @@ STATIC INT32 OsVmPhysSegCreate(paddr_t start, size_t size)
     return 0;
 }
 
+#ifdef LOSCFG_KERNEL_CMA
+/* The top of the highest segment becomes the cma segment, aligned to the largest buddy block */
+STATIC VOID OsVmCmaSegSplit(VOID)
+{
+    struct VmPhysSeg *seg = &g_vmPhysSeg[g_vmPhysSegNum - 1];
+    size_t cmaSize = (size_t)LOSCFG_KERNEL_CMA_SIZE_MB << 20; /* 20: MB to byte */
+    PADDR_T end = seg->start + seg->size;
+    PADDR_T cmaStart;
+
+    if ((cmaSize >= seg->size) || (g_vmPhysSegNum >= VM_PHYS_SEG_MAX)) {
+        VM_ERR("cma size %#x does not fit in segment of size %#x", cmaSize, seg->size);
+        return;
+    }
+
+    cmaStart = ROUNDUP(end - cmaSize, VM_ORDER_TO_PHYS(VM_LIST_ORDER_MAX - 1));
+    if ((cmaStart <= seg->start) || (cmaStart >= end)) {
+        VM_ERR("cma area can not be aligned in segment %#x", seg->start);
+        return;
+    }
+
+    seg->size = cmaStart - seg->start;
+    if (OsVmPhysSegCreate(cmaStart, end - cmaStart) != 0) {
+        seg->size = end - seg->start;
+        return;
+    }
+    g_vmPhysSeg[g_vmPhysSegNum - 1].isCma = TRUE;
+}
+#endif
+
 VOID OsVmPhysSegAdd(VOID)
 {
     INT32 i, ret;
@@ -101,6 +131,9 @@ VOID OsVmPhysSegAdd(VOID)
             VM_ERR("create phys seg failed");
         }
     }
+#ifdef LOSCFG_KERNEL_CMA
+    OsVmCmaSegSplit();
+#endif
 }
 
 VOID OsVmPhysAreaSizeAdjust(size_t size)
@@ -142,6 +175,19 @@ STATIC INLINE VOID OsVmPhysFreeListInit(struct VmPhysSeg *seg)
     LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
 }
 
+STATIC INLINE VOID OsVmPcpListInit(struct VmPhysSeg *seg)
+{
+    struct VmPcpList *pcp = NULL;
+    UINT32 cpuid;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        pcp = &seg->pcpList[cpuid];
+        LOS_SpinInit(&pcp->lock);
+        LOS_ListInit(&pcp->node);
+        pcp->count = 0;
+    }
+}
+
 VOID OsVmPhysInit(VOID)
 {
     struct VmPhysSeg *seg = NULL;
@@ -153,6 +199,7 @@ VOID OsVmPhysInit(VOID)
         seg->pageBase = &g_vmPageArray[nPages];
         nPages += seg->size >> PAGE_SHIFT;
         OsVmPhysFreeListInit(seg);
+        OsVmPcpListInit(seg);
         OsVmPhysLruInit(seg);
     }
 }
@@ -413,29 +460,186 @@ VOID OsVmPhysPagesFreeContiguous(LosVmPage *page, size_t nPages)
     }
 }
 
-STATIC LosVmPage *OsVmPhysPagesGet(size_t nPages)
+/* Takes up to VM_PCP_BATCH single pages from the buddy lists, called with pcp->lock held */
+STATIC VOID OsVmPcpRefill(struct VmPhysSeg *seg, struct VmPcpList *pcp)
 {
+    LosVmPage *page = NULL;
+    UINT32 i;
+
+    LOS_SpinLock(&seg->freeListLock);
+    for (i = 0; i < VM_PCP_BATCH; i++) {
+        page = OsVmPhysPagesAlloc(seg, ONE_PAGE);
+        if (page == NULL) {
+            break;
+        }
+        LOS_ListTailInsert(&pcp->node, &page->node);
+        pcp->count++;
+    }
+    LOS_SpinUnlock(&seg->freeListLock);
+}
+
+/* Gives the count coldest pages back to the buddy lists, called with pcp->lock held */
+STATIC VOID OsVmPcpDrain(struct VmPhysSeg *seg, struct VmPcpList *pcp, UINT32 count)
+{
+    LosVmPage *page = NULL;
+
+    LOS_SpinLock(&seg->freeListLock);
+    while ((count > 0) && (pcp->count > 0)) {
+        page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_LAST(&pcp->node), LosVmPage, node);
+        LOS_ListDelete(&page->node);
+        pcp->count--;
+        OsVmPhysPagesFree(page, 0);
+        count--;
+    }
+    LOS_SpinUnlock(&seg->freeListLock);
+}
+
+STATIC LosVmPage *OsVmPcpAlloc(struct VmPhysSeg *seg)
+{
+    struct VmPcpList *pcp = NULL;
+    LosVmPage *page = NULL;
     UINT32 intSave;
+
+    /* Interrupts stay off so the task can not move to another cpu while it holds this list */
+    intSave = LOS_IntLock();
+    pcp = &seg->pcpList[ArchCurrCpuid()];
+    LOS_SpinLock(&pcp->lock);
+    if (pcp->count == 0) {
+        OsVmPcpRefill(seg, pcp);
+    }
+
+    if (pcp->count != 0) {
+        page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&pcp->node), LosVmPage, node);
+        LOS_ListDelete(&page->node);
+        pcp->count--;
+    }
+    LOS_SpinUnlock(&pcp->lock);
+    LOS_IntRestore(intSave);
+
+    return page;
+}
+
+STATIC VOID OsVmPcpFree(LosVmPage *page)
+{
+    struct VmPhysSeg *seg = &g_vmPhysSeg[page->segID];
+    struct VmPcpList *pcp = NULL;
+    UINT32 intSave;
+
+    intSave = LOS_IntLock();
+    pcp = &seg->pcpList[ArchCurrCpuid()];
+    LOS_SpinLock(&pcp->lock);
+    LOS_ListAdd(&pcp->node, &page->node);
+    pcp->count++;
+    if (pcp->count > VM_PCP_HIGH) {
+        OsVmPcpDrain(seg, pcp, VM_PCP_BATCH);
+    }
+    LOS_SpinUnlock(&pcp->lock);
+    LOS_IntRestore(intSave);
+}
+
+/* Empties the caches of all cpus, returns TRUE if any page went back to the buddy lists */
+BOOL OsVmPcpDrainAll(VOID)
+{
     struct VmPhysSeg *seg = NULL;
-    LosVmPage *page = NULL;
-    UINT32 segID;
+    struct VmPcpList *pcp = NULL;
+    BOOL drained = FALSE;
+    UINT32 intSave;
+    UINT32 cpuid;
+    INT32 segID;
 
     for (segID = 0; segID < g_vmPhysSegNum; segID++) {
         seg = &g_vmPhysSeg[segID];
+        for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+            pcp = &seg->pcpList[cpuid];
+            LOS_SpinLockSave(&pcp->lock, &intSave);
+            if (pcp->count != 0) {
+                OsVmPcpDrain(seg, pcp, pcp->count);
+                drained = TRUE;
+            }
+            LOS_SpinUnlockRestore(&pcp->lock, intSave);
+        }
+    }
+    return drained;
+}
+
+UINT32 OsVmPcpPagesGet(struct VmPhysSeg *seg)
+{
+    UINT32 count = 0;
+    UINT32 cpuid;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        count += seg->pcpList[cpuid].count;
+    }
+    return count;
+}
+
+LosVmPage *OsVmPhysSegPagesAlloc(struct VmPhysSeg *seg, size_t nPages)
+{
+    UINT32 intSave;
+    LosVmPage *page = NULL;
+
+    if (nPages == ONE_PAGE) {
+        page = OsVmPcpAlloc(seg);
+    } else {
         LOS_SpinLockSave(&seg->freeListLock, &intSave);
         page = OsVmPhysPagesAlloc(seg, nPages);
+        LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+    }
+    if (page != NULL) {
+        /* the first page of continuous physical addresses holds refCounts */
+        LOS_AtomicSet(&page->refCounts, 0);
+        page->nPages = nPages;
+    }
+    return page;
+}
+
+STATIC LosVmPage *OsVmPhysPagesTryGet(size_t nPages)
+{
+    struct VmPhysSeg *seg = NULL;
+    LosVmPage *page = NULL;
+    UINT32 segID;
+
+    for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+        seg = &g_vmPhysSeg[segID];
+#ifdef LOSCFG_KERNEL_CMA
+        /* Pages that can not be moved would pin the cma area */
+        if (seg->isCma) {
+            continue;
+        }
+#endif
+        page = OsVmPhysSegPagesAlloc(seg, nPages);
         if (page != NULL) {
-            /* the first page of continuous physical addresses holds refCounts */
-            LOS_AtomicSet(&page->refCounts, 0);
-            page->nPages = nPages;
-            LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
             return page;
         }
-        LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
     }
     return NULL;
 }
 
+STATIC LosVmPage *OsVmPhysPagesGet(size_t nPages)
+{
+    LosVmPage *page = OsVmPhysPagesTryGet(nPages);
+    if (page != NULL) {
+        return page;
+    }
+
+#ifdef LOSCFG_KERNEL_VM_ZERO_POOL
+    (VOID)OsVmZeroPoolShrink();
+#endif
+    /* The pages cached by the cpus may be the last free ones or keep larger blocks from merging */
+    if (OsVmPcpDrainAll()) {
+        page = OsVmPhysPagesTryGet(nPages);
+    }
+#ifdef LOSCFG_KERNEL_VM_COMPACTION
+    if ((page == NULL) && (nPages > ONE_PAGE)) {
+        OsVmCompactWakeup();
+        if (!OS_INT_ACTIVE && OsVmCompact(OsVmPagesToOrder(nPages))) {
+            page = OsVmPhysPagesTryGet(nPages);
+        }
+    }
+#endif
+    return page;
+}
+
 VOID *LOS_PhysPagesAllocContiguous(size_t nPages)
 {
     LosVmPage *page = NULL;
@@ -445,6 +649,11 @@ VOID *LOS_PhysPagesAllocContiguous(size_t nPages)
     }
 
     page = OsVmPhysPagesGet(nPages);
+#ifdef LOSCFG_KERNEL_CMA
+    if ((page == NULL) && (nPages > ONE_PAGE)) {
+        page = OsVmCmaPagesAlloc(nPages);
+    }
+#endif
     if (page == NULL) {
         return NULL;
     }
@@ -469,6 +678,11 @@ VOID LOS_PhysPagesFreeContiguous(VOID *ptr, size_t nPages)
     }
     page->nPages = 0;
 
+    if (nPages == ONE_PAGE) {
+        OsVmPcpFree(page);
+        return;
+    }
+
     seg = &g_vmPhysSeg[page->segID];
     LOS_SpinLockSave(&seg->freeListLock, &intSave);
 
@@ -477,6 +691,110 @@ VOID LOS_PhysPagesFreeContiguous(VOID *ptr, size_t nPages)
     LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
 }
 
+/* Returns the head of the free buddy block covering page, NULL if the page is in use */
+STATIC LosVmPage *OsVmPhysFreeHeadGet(struct VmPhysSeg *seg, LosVmPage *page)
+{
+    LosVmPage *head = NULL;
+    PADDR_T pa;
+    UINT32 order;
+
+    for (order = 0; order < VM_LIST_ORDER_MAX; order++) {
+        pa = VM_PAGE_TO_PHYS(page) & ~(VM_ORDER_TO_PHYS(order) - 1);
+        if (pa < seg->start) {
+            break;
+        }
+        head = seg->pageBase + ((pa - seg->start) >> PAGE_SHIFT);
+        if (head->order == order) {
+            return head;
+        }
+    }
+    return NULL;
+}
+
+/* Takes the nPages pages from start out of the buddy lists, they are either all free or none is taken */
+STATIC BOOL OsVmPhysPagesRangeGet(struct VmPhysSeg *seg, LosVmPage *start, size_t nPages)
+{
+    LosVmPage *end = &start[nPages];
+    LosVmPage *head = NULL;
+    LosVmPage *next = NULL;
+    LosVmPage *cur = NULL;
+
+    if (((size_t)(start - seg->pageBase) + nPages) > (seg->size >> PAGE_SHIFT)) {
+        return FALSE;
+    }
+
+    for (cur = start; cur < end; cur = &head[VM_ORDER_TO_PAGES(head->order)]) {
+        head = OsVmPhysFreeHeadGet(seg, cur);
+        if (head == NULL) {
+            return FALSE;
+        }
+    }
+
+    /* Blocks sticking out of the range on either side give the outer part back */
+    for (cur = start; cur < end; cur = next) {
+        head = OsVmPhysFreeHeadGet(seg, cur);
+        next = &head[VM_ORDER_TO_PAGES(head->order)];
+        OsVmPhysFreeListDelUnsafe(head);
+        if (head < start) {
+            OsVmPhysPagesFreeContiguous(head, start - head);
+        }
+        if (next > end) {
+            OsVmPhysPagesFreeContiguous(end, next - end);
+        }
+    }
+
+    return TRUE;
+}
+
+LosVmPage *OsVmPhysRangeAlloc(struct VmPhysSeg *seg, LosVmPage *start, size_t nPages)
+{
+    UINT32 intSave;
+    BOOL taken;
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    taken = OsVmPhysPagesRangeGet(seg, start, nPages);
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+    if (!taken) {
+        return NULL;
+    }
+
+    LOS_AtomicSet(&start->refCounts, 0);
+    start->nPages = nPages;
+    return start;
+}
+
+STATUS_T LOS_PhysPagesResizeContiguous(VOID *ptr, size_t nPages)
+{
+    UINT32 intSave;
+    struct VmPhysSeg *seg = NULL;
+    LosVmPage *page = NULL;
+    STATUS_T ret = LOS_OK;
+
+    if ((ptr == NULL) || (nPages == 0)) {
+        return LOS_NOK;
+    }
+
+    page = OsVmVaddrToPage(ptr);
+    if ((page == NULL) || (page->nPages == 0)) {
+        return LOS_NOK;
+    }
+
+    seg = &g_vmPhysSeg[page->segID];
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    if (nPages < page->nPages) {
+        OsVmPhysPagesFreeContiguous(&page[nPages], page->nPages - nPages);
+    } else if ((nPages > page->nPages) && !OsVmPhysPagesRangeGet(seg, &page[page->nPages], nPages - page->nPages)) {
+        ret = LOS_NOK;
+    }
+
+    if (ret == LOS_OK) {
+        page->nPages = nPages;
+    }
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+
+    return ret;
+}
+
 VADDR_T *LOS_PaddrToKVaddr(PADDR_T paddr)
 {
     struct VmPhysSeg *seg = NULL;
@@ -494,21 +812,13 @@ VADDR_T *LOS_PaddrToKVaddr(PADDR_T paddr)
 
 VOID LOS_PhysPageFree(LosVmPage *page)
 {
-    UINT32 intSave;
-    struct VmPhysSeg *seg = NULL;
-
     if (page == NULL) {
         return;
     }
 
     if (LOS_AtomicDecRet(&page->refCounts) <= 0) {
-        seg = &g_vmPhysSeg[page->segID];
-        LOS_SpinLockSave(&seg->freeListLock, &intSave);
-
-        OsVmPhysPagesFreeContiguous(page, ONE_PAGE);
         LOS_AtomicSet(&page->refCounts, 0);
-
-        LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+        OsVmPcpFree(page);
     }
 }
 
@@ -517,6 +827,44 @@ LosVmPage *LOS_PhysPageAlloc(VOID)
     return OsVmPhysPagesGet(ONE_PAGE);
 }
 
+LosVmPage *LOS_PhysPageAllocZeroed(VOID)
+{
+    LosVmPage *page = NULL;
+
+#ifdef LOSCFG_KERNEL_VM_ZERO_POOL
+    page = OsVmZeroPoolGet();
+    if (page != NULL) {
+        return page;
+    }
+#endif
+
+    page = LOS_PhysPageAlloc();
+    if (page != NULL) {
+        (VOID)memset_s(OsVmPageToVaddr(page), PAGE_SIZE, 0, PAGE_SIZE);
+    }
+    return page;
+}
+
+LosVmPage *LOS_PhysPageAllocMovable(VOID)
+{
+#ifdef LOSCFG_KERNEL_CMA
+    LosVmPage *page = NULL;
+    UINT32 segID;
+
+    for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+        if (!g_vmPhysSeg[segID].isCma) {
+            continue;
+        }
+        page = OsVmPhysSegPagesAlloc(&g_vmPhysSeg[segID], ONE_PAGE);
+        if (page != NULL) {
+            (VOID)memset_s(OsVmPageToVaddr(page), PAGE_SIZE, 0, PAGE_SIZE);
+            return page;
+        }
+    }
+#endif
+    return LOS_PhysPageAllocZeroed();
+}
+
 size_t LOS_PhysPagesAlloc(size_t nPages, LOS_DL_LIST *list)
 {
     LosVmPage *page = NULL;
@@ -599,10 +947,8 @@ UINT32 OsVmPagesToOrder(size_t nPages)
 
 size_t LOS_PhysPagesFree(LOS_DL_LIST *list)
 {
-    UINT32 intSave;
     LosVmPage *page = NULL;
     LosVmPage *nPage = NULL;
-    LosVmPhysSeg *seg = NULL;
     size_t count = 0;
 
     if (list == NULL) {
@@ -612,11 +958,8 @@ size_t LOS_PhysPagesFree(LOS_DL_LIST *list)
     LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(page, nPage, list, LosVmPage, node) {
         LOS_ListDelete(&page->node);
         if (LOS_AtomicDecRet(&page->refCounts) <= 0) {
-            seg = &g_vmPhysSeg[page->segID];
-            LOS_SpinLockSave(&seg->freeListLock, &intSave);
-            OsVmPhysPagesFreeContiguous(page, ONE_PAGE);
             LOS_AtomicSet(&page->refCounts, 0);
-            LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+            OsVmPcpFree(page);
         }
         count++;
     }
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_vm_radix.h"
+#include "los_vm_common.h"
+#include "los_slab_pri.h"
+#include "securec.h"
+
+#ifdef LOSCFG_KERNEL_VM
+
+#define VM_RADIX_INDEX_MAX      0xFFFFFFFFU
+#define VM_RADIX_TAG_ANY        VM_RADIX_TAG_MAX
+
+typedef struct {
+    VmRadixNode *node;
+    UINT32 offset;
+} VmRadixPath;
+
+LITE_OS_SEC_BSS STATIC SlabCache *g_radixNodeCache = NULL;
+
+VOID OsVmRadixInit(VOID)
+{
+    g_radixNodeCache = OsSlabCacheCreate("radix_node", sizeof(VmRadixNode), NULL);
+    if (g_radixNodeCache == NULL) {
+        VM_ERR("create radix node slab failed");
+    }
+}
+
+STATIC VmRadixNode *OsVmRadixNodeAlloc(VOID)
+{
+    VmRadixNode *node = (VmRadixNode *)OsSlabAlloc(g_radixNodeCache);
+
+    if (node != NULL) {
+        (VOID)memset_s(node, sizeof(VmRadixNode), 0, sizeof(VmRadixNode));
+    }
+    return node;
+}
+
+STATIC INLINE UINT32 OsVmRadixMaxIndex(UINT32 height)
+{
+    UINT32 bits = height * VM_RADIX_SHIFT;
+
+    return (bits >= 32) ? VM_RADIX_INDEX_MAX : ((1U << bits) - 1); /* 32: index bits */
+}
+
+/* Records the nodes from the root down towards index, returns the number of levels found */
+STATIC UINT32 OsVmRadixPathGet(const VmRadixTree *tree, UINT32 index, VmRadixPath *path)
+{
+    VmRadixNode *node = tree->root;
+    UINT32 shift = (tree->height - 1) * VM_RADIX_SHIFT;
+    UINT32 level = 0;
+
+    if ((node == NULL) || (index > OsVmRadixMaxIndex(tree->height))) {
+        return 0;
+    }
+
+    while (node != NULL) {
+        path[level].node = node;
+        path[level].offset = (index >> shift) & VM_RADIX_MASK;
+        if (++level == tree->height) {
+            break;
+        }
+        node = (VmRadixNode *)node->slots[path[level - 1].offset];
+        shift -= VM_RADIX_SHIFT;
+    }
+    return level;
+}
+
+STATIC VOID OsVmRadixShrink(VmRadixTree *tree)
+{
+    VmRadixNode *root = NULL;
+
+    while (tree->height > 1) {
+        root = tree->root;
+        if ((root->count != 1) || (root->slots[0] == NULL)) {
+            break;
+        }
+        tree->root = (VmRadixNode *)root->slots[0];
+        tree->height--;
+        OsSlabFree(g_radixNodeCache, root);
+    }
+}
+
+/* Frees the empty nodes at the bottom of path and drops root levels no longer needed */
+STATIC VOID OsVmRadixPathRelease(VmRadixTree *tree, VmRadixPath *path, UINT32 levels)
+{
+    VmRadixNode *node = NULL;
+
+    while (levels > 0) {
+        node = path[levels - 1].node;
+        if (node->count != 0) {
+            break;
+        }
+        OsSlabFree(g_radixNodeCache, node);
+        if (--levels == 0) {
+            OsVmRadixTreeInit(tree);
+            return;
+        }
+        path[levels - 1].node->slots[path[levels - 1].offset] = NULL;
+        path[levels - 1].node->count--;
+    }
+    OsVmRadixShrink(tree);
+}
+
+STATIC VOID OsVmRadixPathTagClear(VmRadixPath *path, UINT32 levels, enum VmRadixTag tag)
+{
+    while (levels > 0) {
+        levels--;
+        path[levels].node->tags[tag] &= ~(1U << path[levels].offset);
+        if (path[levels].node->tags[tag] != 0) {
+            break;
+        }
+    }
+}
+
+STATUS_T OsVmRadixInsert(VmRadixTree *tree, UINT32 index, VOID *item)
+{
+    VmRadixPath path[VM_RADIX_HEIGHT_MAX];
+    VmRadixNode *node = NULL;
+    VmRadixNode *child = NULL;
+    UINT32 shift;
+    UINT32 tag;
+
+    if (item == NULL) {
+        return LOS_ERRNO_VM_INVALID_ARGS;
+    }
+
+    if (tree->root == NULL) {
+        tree->root = OsVmRadixNodeAlloc();
+        if (tree->root == NULL) {
+            return LOS_ERRNO_VM_NO_MEMORY;
+        }
+        tree->height = 1;
+        while (index > OsVmRadixMaxIndex(tree->height)) {
+            tree->height++;
+        }
+    }
+
+    while (index > OsVmRadixMaxIndex(tree->height)) {
+        node = OsVmRadixNodeAlloc();
+        if (node == NULL) {
+            goto NO_MEMORY;
+        }
+        node->slots[0] = tree->root;
+        node->count = 1;
+        for (tag = 0; tag < VM_RADIX_TAG_MAX; tag++) {
+            node->tags[tag] = (tree->root->tags[tag] != 0) ? 1 : 0;
+        }
+        tree->root = node;
+        tree->height++;
+    }
+
+    node = tree->root;
+    for (shift = (tree->height - 1) * VM_RADIX_SHIFT; shift > 0; shift -= VM_RADIX_SHIFT) {
+        child = (VmRadixNode *)node->slots[(index >> shift) & VM_RADIX_MASK];
+        if (child == NULL) {
+            child = OsVmRadixNodeAlloc();
+            if (child == NULL) {
+                goto NO_MEMORY;
+            }
+            node->slots[(index >> shift) & VM_RADIX_MASK] = child;
+            node->count++;
+        }
+        node = child;
+    }
+
+    if (node->slots[index & VM_RADIX_MASK] != NULL) {
+        return LOS_ERRNO_VM_ALREADY_EXISTS;
+    }
+    node->slots[index & VM_RADIX_MASK] = item;
+    node->count++;
+    return LOS_OK;
+
+NO_MEMORY:
+    OsVmRadixPathRelease(tree, path, OsVmRadixPathGet(tree, index, path));
+    return LOS_ERRNO_VM_NO_MEMORY;
+}
+
+VOID *OsVmRadixDelete(VmRadixTree *tree, UINT32 index)
+{
+    VmRadixPath path[VM_RADIX_HEIGHT_MAX];
+    UINT32 levels = OsVmRadixPathGet(tree, index, path);
+    VmRadixNode *leaf = NULL;
+    UINT32 offset;
+    UINT32 tag;
+    VOID *item = NULL;
+
+    if ((levels == 0) || (levels != tree->height)) {
+        return NULL;
+    }
+
+    leaf = path[levels - 1].node;
+    offset = path[levels - 1].offset;
+    item = leaf->slots[offset];
+    if (item == NULL) {
+        return NULL;
+    }
+
+    for (tag = 0; tag < VM_RADIX_TAG_MAX; tag++) {
+        if (leaf->tags[tag] & (1U << offset)) {
+            OsVmRadixPathTagClear(path, levels, (enum VmRadixTag)tag);
+        }
+    }
+    leaf->slots[offset] = NULL;
+    leaf->count--;
+    OsVmRadixPathRelease(tree, path, levels);
+    return item;
+}
+
+VOID *OsVmRadixLookup(const VmRadixTree *tree, UINT32 index)
+{
+    VmRadixPath path[VM_RADIX_HEIGHT_MAX];
+    UINT32 levels = OsVmRadixPathGet(tree, index, path);
+
+    if ((levels == 0) || (levels != tree->height)) {
+        return NULL;
+    }
+    return path[levels - 1].node->slots[path[levels - 1].offset];
+}
+
+/* Returns the first item at or after *index, tagged with tag unless it is VM_RADIX_TAG_ANY */
+STATIC VOID *OsVmRadixNextGet(const VmRadixTree *tree, UINT32 *index, UINT32 tag)
+{
+    UINT64 maxIndex = OsVmRadixMaxIndex(tree->height);
+    UINT64 next = *index;
+    UINT64 span;
+    UINT32 start;
+    UINT32 shift;
+    UINT32 offset;
+    VmRadixNode *node = NULL;
+
+    if (tree->root == NULL) {
+        return NULL;
+    }
+
+    while (next <= maxIndex) {
+        start = (UINT32)next;
+        node = tree->root;
+        shift = (tree->height - 1) * VM_RADIX_SHIFT;
+        while (TRUE) {
+            for (offset = (start >> shift) & VM_RADIX_MASK; offset < VM_RADIX_SLOTS; offset++) {
+                if ((node->slots[offset] != NULL) &&
+                    ((tag == VM_RADIX_TAG_ANY) || (node->tags[tag] & (1U << offset)))) {
+                    break;
+                }
+            }
+
+            span = (UINT64)1 << (shift + VM_RADIX_SHIFT);
+            if (offset == VM_RADIX_SLOTS) {
+                /* nothing left under this node, go on from where the next one starts */
+                next = ((UINT64)start & ~(span - 1)) + span;
+                break;
+            }
+            if (offset != ((start >> shift) & VM_RADIX_MASK)) {
+                start = (UINT32)(((UINT64)start & ~(span - 1)) | ((UINT64)offset << shift));
+            }
+            if (shift == 0) {
+                *index = start;
+                return node->slots[offset];
+            }
+            node = (VmRadixNode *)node->slots[offset];
+            shift -= VM_RADIX_SHIFT;
+        }
+    }
+
+    return NULL;
+}
+
+STATIC UINT32 OsVmRadixGang(const VmRadixTree *tree, VOID **results, UINT32 first, UINT32 maxItems, UINT32 tag)
+{
+    UINT32 index = first;
+    UINT32 nr = 0;
+    VOID *item = NULL;
+
+    while (nr < maxItems) {
+        item = OsVmRadixNextGet(tree, &index, tag);
+        if (item == NULL) {
+            break;
+        }
+        results[nr++] = item;
+        if (index == VM_RADIX_INDEX_MAX) {
+            break;
+        }
+        index++;
+    }
+
+    return nr;
+}
+
+/* Fills results with up to maxItems items in ascending index order, starting at first */
+UINT32 OsVmRadixGangLookup(const VmRadixTree *tree, VOID **results, UINT32 first, UINT32 maxItems)
+{
+    return OsVmRadixGang(tree, results, first, maxItems, VM_RADIX_TAG_ANY);
+}
+
+UINT32 OsVmRadixGangLookupTag(const VmRadixTree *tree, VOID **results, UINT32 first, UINT32 maxItems,
+                              enum VmRadixTag tag)
+{
+    return OsVmRadixGang(tree, results, first, maxItems, tag);
+}
+
+VOID OsVmRadixTagSet(VmRadixTree *tree, UINT32 index, enum VmRadixTag tag)
+{
+    VmRadixPath path[VM_RADIX_HEIGHT_MAX];
+    UINT32 levels = OsVmRadixPathGet(tree, index, path);
+    UINT32 i;
+
+    if ((levels == 0) || (levels != tree->height) ||
+        (path[levels - 1].node->slots[path[levels - 1].offset] == NULL)) {
+        return;
+    }
+
+    for (i = 0; i < levels; i++) {
+        path[i].node->tags[tag] |= (1U << path[i].offset);
+    }
+}
+
+VOID OsVmRadixTagClear(VmRadixTree *tree, UINT32 index, enum VmRadixTag tag)
+{
+    VmRadixPath path[VM_RADIX_HEIGHT_MAX];
+    UINT32 levels = OsVmRadixPathGet(tree, index, path);
+
+    if ((levels == 0) || (levels != tree->height)) {
+        return;
+    }
+    OsVmRadixPathTagClear(path, levels, tag);
+}
+
+BOOL OsVmRadixTagGet(const VmRadixTree *tree, UINT32 index, enum VmRadixTag tag)
+{
+    VmRadixPath path[VM_RADIX_HEIGHT_MAX];
+    UINT32 levels = OsVmRadixPathGet(tree, index, path);
+
+    if ((levels == 0) || (levels != tree->height)) {
+        return FALSE;
+    }
+    return (path[levels - 1].node->tags[tag] & (1U << path[levels - 1].offset)) ? TRUE : FALSE;
+}
+
+#endif
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_vm_filemap.h"
+#include "los_vm_common.h"
+#include "los_event.h"
+#include "los_init.h"
+#include "los_task_pri.h"
+#include "vnode.h"
+#include "securec.h"
+
+#ifdef LOSCFG_KERNEL_VM_READAHEAD
+#define OS_RA_INIT_PAGES            4
+#define OS_RA_QUEUE_SIZE            8
+#define OS_RA_EVENT_WORK            0x01
+#define OS_RA_STACK_SIZE            0x1000
+
+typedef struct {
+    struct Vnode *vnode;    /* Held by useCount until the work is done */
+    VM_OFFSET_T start;
+    UINT32 nPages;
+} VmReadaheadWork;
+
+typedef struct {
+    SPIN_LOCK_S lock;
+    VmReadaheadWork works[OS_RA_QUEUE_SIZE];
+    UINT32 head;
+    UINT32 count;
+} VmReadaheadQueue;
+
+STATIC VmReadaheadQueue g_vmRaQueue = {
+    .lock = SPIN_LOCK_INITIALIZER(g_vmRaQueue),
+};
+STATIC EVENT_CB_S g_vmRaEvent;
+STATIC BOOL g_vmRaReady = FALSE;
+
+STATIC INLINE VOID OsVmReadaheadVnodeGet(struct Vnode *vnode)
+{
+    VnodeHold();
+    vnode->useCount++;
+    VnodeDrop();
+}
+
+STATIC INLINE VOID OsVmReadaheadVnodePut(struct Vnode *vnode)
+{
+    VnodeHold();
+    vnode->useCount--;
+    VnodeDrop();
+}
+
+/* Window sizes go 4, 8, 16... up to the configured maximum */
+STATIC INLINE UINT32 OsVmReadaheadNextSize(UINT32 size)
+{
+    size = (size < OS_RA_INIT_PAGES) ? OS_RA_INIT_PAGES : (size << 1);
+    return MIN2(size, VM_READAHEAD_PAGES_MAX);
+}
+
+/* Clips a window to the end of the file, the file system zero fills the last partial page */
+STATIC UINT32 OsVmReadaheadClip(struct Vnode *vnode, VM_OFFSET_T start, UINT32 nPages)
+{
+    struct stat st;
+    UINT64 end;
+
+    if ((vnode->vop->Getattr == NULL) || (vnode->vop->Getattr(vnode, &st) != LOS_OK)) {
+        return nPages;
+    }
+
+    end = ROUNDUP((UINT64)st.st_size, PAGE_SIZE) >> PAGE_SHIFT;
+    if (start >= end) {
+        return 0;
+    }
+    return (UINT32)MIN2((UINT64)nPages, end - start);
+}
+
+STATIC VOID OsVmReadaheadAsync(struct Vnode *vnode, VM_OFFSET_T start, UINT32 nPages)
+{
+    VmReadaheadWork *work = NULL;
+    BOOL queued = FALSE;
+    UINT32 intSave;
+
+    if (!g_vmRaReady) {
+        return;
+    }
+
+    OsVmReadaheadVnodeGet(vnode);
+    LOS_SpinLockSave(&g_vmRaQueue.lock, &intSave);
+    if (g_vmRaQueue.count < OS_RA_QUEUE_SIZE) {
+        work = &g_vmRaQueue.works[(g_vmRaQueue.head + g_vmRaQueue.count) % OS_RA_QUEUE_SIZE];
+        work->vnode = vnode;
+        work->start = start;
+        work->nPages = nPages;
+        g_vmRaQueue.count++;
+        queued = TRUE;
+    }
+    LOS_SpinUnlockRestore(&g_vmRaQueue.lock, intSave);
+
+    if (!queued) {
+        /* the task is behind already, the reader faults the window in synchronously instead */
+        OsVmReadaheadVnodePut(vnode);
+        return;
+    }
+    (VOID)LOS_EventWrite(&g_vmRaEvent, OS_RA_EVENT_WORK);
+}
+
+/*
+ * Called on every file page fault with mux_lock held, before the page is looked up. A miss that continues
+ * the previous window reads a larger one synchronously, the faulting page first. A fault on the readahead
+ * marker queues the following window to the readahead task, so the reader does not wait for it.
+ */
+VOID OsVmReadahead(LosVmMapRegion *region, VM_OFFSET_T pgoff)
+{
+    struct VmReadahead *ra = &region->unTypeData.rf.ra;
+    struct Vnode *vnode = region->unTypeData.rf.vnode;
+    struct page_mapping *mapping = &vnode->mapping;
+    LosFilePage *fpage = NULL;
+    BOOL cached = FALSE;
+    BOOL marker = FALSE;
+    BOOL sequential;
+    UINT32 intSave;
+    UINT32 size;
+
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    fpage = OsFindGetEntry(mapping, pgoff);
+    if (fpage != NULL) {
+        cached = TRUE;
+        if (OsIsPageReadahead(fpage->vmPage)) {
+            OsCleanPageReadahead(fpage->vmPage);
+            marker = TRUE;
+        }
+    }
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+    sequential = (pgoff == (ra->prevPgoff + 1)) || ((pgoff >= ra->start) && (pgoff <= (ra->start + ra->size)));
+    ra->prevPgoff = pgoff;
+
+    if (marker) {
+        if ((pgoff < ra->start) || (pgoff >= (ra->start + ra->size))) {
+            /* marker of another mapping of the file, ramp up from here */
+            ra->start = pgoff;
+            ra->size = 1;
+        }
+        ra->start += ra->size;
+        ra->size = OsVmReadaheadNextSize(ra->size);
+        ra->asyncSize = ra->size;
+        size = OsVmReadaheadClip(vnode, ra->start, ra->size);
+        if (size > 0) {
+            OsVmReadaheadAsync(vnode, ra->start, size);
+        }
+        return;
+    }
+
+    if (cached) {
+        return;
+    }
+
+    if (!sequential && (pgoff != 0)) {
+        /* random access, only the faulting page is read */
+        ra->start = pgoff;
+        ra->size = 1;
+        ra->asyncSize = 0;
+        return;
+    }
+
+    ra->start = pgoff;
+    ra->size = OsVmReadaheadNextSize(ra->size);
+    ra->asyncSize = ra->size - 1;
+    size = OsVmReadaheadClip(vnode, pgoff, ra->size);
+    if (size > 1) {
+        (VOID)OsPageCacheReadPages(mapping, pgoff, size, pgoff + ra->size - ra->asyncSize);
+    }
+}
+
+STATIC BOOL OsVmReadaheadWorkGet(VmReadaheadWork *work)
+{
+    BOOL found = FALSE;
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&g_vmRaQueue.lock, &intSave);
+    if (g_vmRaQueue.count > 0) {
+        *work = g_vmRaQueue.works[g_vmRaQueue.head];
+        g_vmRaQueue.head = (g_vmRaQueue.head + 1) % OS_RA_QUEUE_SIZE;
+        g_vmRaQueue.count--;
+        found = TRUE;
+    }
+    LOS_SpinUnlockRestore(&g_vmRaQueue.lock, intSave);
+    return found;
+}
+
+STATIC VOID OsVmReadaheadTask(VOID)
+{
+    VmReadaheadWork work;
+    struct page_mapping *mapping = NULL;
+
+    while (1) {
+        (VOID)LOS_EventRead(&g_vmRaEvent, OS_RA_EVENT_WORK, LOS_WAITMODE_OR | LOS_WAITMODE_CLR, LOS_WAIT_FOREVER);
+        while (OsVmReadaheadWorkGet(&work)) {
+            mapping = &work.vnode->mapping;
+            (VOID)LOS_MuxAcquire(&mapping->mux_lock);
+            /* the marker goes on the first page, reaching it starts the window after this one */
+            (VOID)OsPageCacheReadPages(mapping, work.start, work.nPages, work.start);
+            (VOID)LOS_MuxRelease(&mapping->mux_lock);
+            OsVmReadaheadVnodePut(work.vnode);
+        }
+    }
+}
+
+STATIC UINT32 OsVmReadaheadInit(VOID)
+{
+    UINT32 ret;
+    UINT32 taskID;
+    TSK_INIT_PARAM_S taskInitParam;
+
+    ret = LOS_EventInit(&g_vmRaEvent);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    (VOID)memset_s((VOID *)(&taskInitParam), sizeof(TSK_INIT_PARAM_S), 0, sizeof(TSK_INIT_PARAM_S));
+    taskInitParam.pfnTaskEntry = (TSK_ENTRY_FUNC)OsVmReadaheadTask;
+    taskInitParam.uwStackSize = OS_RA_STACK_SIZE;
+    taskInitParam.pcName = "ReadaheadTask";
+    /* same as the user tasks it reads for, it mostly sleeps on I/O anyway */
+    taskInitParam.usTaskPrio = LOSCFG_BASE_CORE_TSK_DEFAULT_PRIO;
+    ret = LOS_TaskCreate(&taskID, &taskInitParam);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+    OS_TCB_FROM_TID(taskID)->taskStatus |= OS_TASK_FLAG_NO_DELETE;
+
+    g_vmRaReady = TRUE;
+    return LOS_OK;
+}
+
+LOS_MODULE_INIT(OsVmReadaheadInit, LOS_INIT_LEVEL_KMOD_TASK);
+#endif
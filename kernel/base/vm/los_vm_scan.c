@@ -33,6 +33,7 @@
 
 #include "fs/file.h"
 #include "los_vm_filemap.h"
+#include "los_hw.h"
 
 #ifdef LOSCFG_KERNEL_VM
 
@@ -47,7 +48,7 @@ VOID OsUnmapPageLocked(LosFilePage *page, LosMapInfo *info)
     LOS_ListDelete(&info->node);
     LOS_AtomicDec(&page->vmPage->refCounts);
     LOS_ArchMmuUnmap(info->archMmu, info->vaddr, 1);
-    LOS_MemFree(m_aucSysMem0, info);
+    OsMapInfoFree(info);
 }
 
 VOID OsUnmapAllLocked(LosFilePage *page)
@@ -69,6 +70,7 @@ VOID OsLruCacheAdd(LosFilePage *fpage, enum OsLruList lruType)
     LosVmPage *page = fpage->vmPage;
 
     LOS_SpinLockSave(&physSeg->lruLock, &intSave);
+    OsSetPageLRU(page);
     OsSetPageActive(page);
     OsCleanPageReferenced(page);
     physSeg->lruSize[lruType]++;
@@ -83,8 +85,20 @@ VOID OsLruCacheDel(LosFilePage *fpage)
     LosVmPhysSeg *physSeg = fpage->physSeg;
     int type = OsIsPageActive(fpage->vmPage) ? VM_LRU_ACTIVE_FILE : VM_LRU_INACTIVE_FILE;
 
+    /* an isolated page is unlinked from the evacuation list, which is guarded by the same lru lock */
+    if (OsIsPageIsolated(fpage->vmPage)) {
+        OsCleanPageIsolated(fpage->vmPage);
+        LOS_ListDelete(&fpage->lru);
+        return;
+    }
+
+    /* a page released before it made it into the page cache was never added */
+    if (!OsIsPageLRU(fpage->vmPage)) {
+        return;
+    }
     physSeg->lruSize[type]--;
     LOS_ListDelete(&fpage->lru);
+    OsCleanPageLRU(fpage->vmPage);
 }
 
 BOOL OsInactiveListIsLow(LosVmPhysSeg *physSeg)
@@ -160,6 +174,12 @@ VOID OsPageRefIncLocked(LosFilePage *fpage)
         OsSetPageReferenced(page);
     }
 
+    /* a page off the lru is being evacuated, the flags alone pick the list it goes back on */
+    if (!OsIsPageLRU(page)) {
+        LOS_SpinUnlockRestore(&fpage->physSeg->lruLock, intSave);
+        return;
+    }
+
     if (!isOrgActive && OsIsPageActive(page)) {
         /* move inactive to active */
         OsMoveToActiveList(fpage);
@@ -201,7 +221,7 @@ VOID OsPageRefDecNoLock(LosFilePage *fpage)
         OsCleanPageReferenced(page);
     }
 
-    if (isOrgActive && !OsIsPageActive(page)) {
+    if (isOrgActive && !OsIsPageActive(page) && OsIsPageLRU(page)) {
         OsMoveToInactiveList(fpage);
     }
 }
@@ -285,6 +305,135 @@ int OsShrinkInactiveList(LosVmPhysSeg *physSeg, int nScan, LOS_DL_LIST *list)
     return nrReclaimed;
 }
 
+/* Puts an isolated page back on the lru list its flags select, called with the lru lock of its segment held */
+STATIC VOID OsFilePagePutback(LosFilePage *fpage)
+{
+    LosVmPhysSeg *physSeg = fpage->physSeg;
+    enum OsLruList type = OsIsPageActive(fpage->vmPage) ? VM_LRU_ACTIVE_FILE : VM_LRU_INACTIVE_FILE;
+
+    OsSetPageLRU(fpage->vmPage);
+    physSeg->lruSize[type]++;
+    LOS_ListTailInsert(&physSeg->lruList[type], &fpage->lru);
+}
+
+/*
+ * Moves an isolated page cache page to newPage, called with the mapping lock and the lru lock of its segment held.
+ * Mappings are dropped rather than rewritten, the next access faults the new page in.
+ */
+STATIC BOOL OsFilePageMove(LosFilePage *fpage, LosVmPage *newPage)
+{
+    LosVmPage *oldPage = fpage->vmPage;
+
+    /* Locked pages are being read in or mapped by a page fault, other references can not be moved */
+    if (OsIsPageLocked(oldPage) || (LOS_AtomicRead(&oldPage->refCounts) != (INT32)fpage->n_maps)) {
+        return FALSE;
+    }
+
+    if (OsIsPageMapped(fpage)) {
+        OsUnmapAllLocked(fpage);
+    }
+
+    (VOID)memcpy_s(OsVmPageToVaddr(newPage), PAGE_SIZE, OsVmPageToVaddr(oldPage), PAGE_SIZE);
+    if (fpage->flags & VM_MAP_REGION_FLAG_PERM_EXECUTE) {
+        DCacheFlushRange((UINTPTR)OsVmPageToVaddr(newPage), (UINTPTR)OsVmPageToVaddr(newPage) + PAGE_SIZE);
+    }
+    newPage->flags = oldPage->flags;
+    fpage->vmPage = newPage;
+    fpage->physSeg = OsVmPhysSegGet(newPage);
+
+    LOS_PhysPageFree(oldPage);
+    return TRUE;
+}
+
+/* Takes the unlocked page cache pages in [start, start + nPages) off the lru lists of seg */
+STATIC VOID OsFilePagesIsolate(LosVmPhysSeg *seg, LosVmPage *start, LosVmPage *end, LOS_DL_LIST *isolated)
+{
+    LosFilePage *fpage = NULL;
+    LosFilePage *fnext = NULL;
+    INT32 type;
+
+    for (type = VM_LRU_INACTIVE_FILE; type <= VM_LRU_ACTIVE_FILE; type++) {
+        LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(fpage, fnext, &seg->lruList[type], LosFilePage, lru) {
+            if ((fpage->vmPage < start) || (fpage->vmPage >= end) || OsIsPageLocked(fpage->vmPage)) {
+                continue;
+            }
+            seg->lruSize[type]--;
+            LOS_ListDelete(&fpage->lru);
+            OsCleanPageLRU(fpage->vmPage);
+            OsSetPageIsolated(fpage->vmPage);
+            LOS_ListTailInsert(isolated, &fpage->lru);
+        }
+    }
+}
+
+/*
+ * Moves the page cache pages in [start, start + nPages) of seg elsewhere, returns the number left behind.
+ * Candidates are isolated in one pass, then moved one at a time so the lru lock is never held across the walk,
+ * and the lock of the destination segment, which may well be seg itself, is only taken on its own.
+ */
+UINT32 OsFilePagesEvacuate(LosVmPhysSeg *seg, LosVmPage *start, size_t nPages)
+{
+    LosVmPage *end = &start[nPages];
+    LosVmPage *newPage = NULL;
+    LosFilePage *fpage = NULL;
+    LosVmPhysSeg *newSeg = NULL;
+    LOS_DL_LIST_HEAD(isolated);
+    LOS_DL_LIST_HEAD(rejected);
+    UINT32 left = 0;
+    UINT32 intSave;
+    BOOL moved;
+
+    LOS_SpinLockSave(&seg->lruLock, &intSave);
+    OsFilePagesIsolate(seg, start, end, &isolated);
+    LOS_SpinUnlockRestore(&seg->lruLock, intSave);
+
+    while (TRUE) {
+        /* Deleters unlink isolated pages under the same lock, so the list is only touched with it held */
+        LOS_SpinLockSave(&seg->lruLock, &intSave);
+        if (LOS_ListEmpty(&isolated)) {
+            LOS_SpinUnlockRestore(&seg->lruLock, intSave);
+            break;
+        }
+        fpage = LOS_DL_LIST_ENTRY(isolated.pstNext, LosFilePage, lru);
+        LOS_ListDelete(&fpage->lru);
+        OsCleanPageIsolated(fpage->vmPage);
+
+        if (LOS_SpinTrylock(&fpage->mapping->list_lock) != LOS_OK) {
+            OsFilePagePutback(fpage);
+            LOS_SpinUnlockRestore(&seg->lruLock, intSave);
+            left++;
+            continue;
+        }
+
+        /* A free page inside the range is no place to move to, keep it aside until the end */
+        newPage = LOS_PhysPageAlloc();
+        while ((newPage != NULL) && (newPage >= start) && (newPage < end)) {
+            LOS_ListTailInsert(&rejected, &newPage->node);
+            newPage = LOS_PhysPageAlloc();
+        }
+
+        moved = (newPage != NULL) && OsFilePageMove(fpage, newPage);
+        if (!moved) {
+            OsFilePagePutback(fpage);
+            left++;
+        }
+        LOS_SpinUnlock(&seg->lruLock);
+
+        if (moved) {
+            newSeg = fpage->physSeg;
+            LOS_SpinLock(&newSeg->lruLock);
+            OsFilePagePutback(fpage);
+            LOS_SpinUnlock(&newSeg->lruLock);
+        } else if (newPage != NULL) {
+            LOS_PhysPageFree(newPage);
+        }
+        LOS_SpinUnlockRestore(&fpage->mapping->list_lock, intSave);
+    }
+
+    (VOID)LOS_PhysPagesFree(&rejected);
+    return left;
+}
+
 bool InactiveListIsLow(LosVmPhysSeg *physSeg)
 {
     return (physSeg->lruSize[VM_LRU_ACTIVE_FILE] > physSeg->lruSize[VM_LRU_INACTIVE_FILE]) ? TRUE : FALSE;
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_vm_phys.h"
+#include "los_vm_common.h"
+#include "los_vm_dump.h"
+#include "los_event.h"
+#include "los_init.h"
+#include "los_task_pri.h"
+#include "los_seq_buf.h"
+#include "securec.h"
+
+#ifdef LOSCFG_KERNEL_VM_ZERO_POOL
+#define OS_ZERO_POOL_DEFAULT_PAGES  64
+#define OS_ZERO_POOL_MAX_PAGES      1024
+#define OS_ZERO_POOL_EVENT_REFILL   0x01
+#define OS_ZERO_POOL_STACK_SIZE     0x1000
+#define OS_ZERO_POOL_FREE_RESERVE   2   /* free pages must exceed the target this many times to refill */
+
+typedef struct {
+    SPIN_LOCK_S lock;
+    LOS_DL_LIST list;       /* Zero filled pages, each one allocated from the buddy lists */
+    UINT32 count;
+    UINT32 target;          /* Pages the task keeps the pool filled to */
+    UINT32 hits;            /* Zero page requests served from the pool */
+    UINT32 misses;          /* Zero page requests that had to clear a page themselves */
+    UINT32 zeroed;          /* Pages cleared by the task */
+    UINT32 reclaimed;       /* Pages given back under memory pressure */
+} VmZeroPool;
+
+STATIC VmZeroPool g_vmZeroPool = {
+    .lock = SPIN_LOCK_INITIALIZER(g_vmZeroPool),
+    .list = { &g_vmZeroPool.list, &g_vmZeroPool.list },
+    .target = OS_ZERO_POOL_DEFAULT_PAGES,
+};
+STATIC EVENT_CB_S g_vmZeroPoolEvent;
+STATIC BOOL g_vmZeroPoolReady = FALSE;
+
+STATIC VOID OsVmZeroPoolWakeup(VOID)
+{
+    if (g_vmZeroPoolReady) {
+        (VOID)LOS_EventWrite(&g_vmZeroPoolEvent, OS_ZERO_POOL_EVENT_REFILL);
+    }
+}
+
+STATIC BOOL OsVmZeroPoolRoomCheck(VOID)
+{
+    UINT32 usedPages = 0;
+    UINT32 totalPages = 0;
+
+    /* Never compete with real allocations when memory runs low */
+    OsVmPhysUsedInfoGet(&usedPages, &totalPages);
+    return ((totalPages - usedPages) > (g_vmZeroPool.target * OS_ZERO_POOL_FREE_RESERVE));
+}
+
+STATIC VOID OsVmZeroPoolRefill(VOID)
+{
+    VmZeroPool *pool = &g_vmZeroPool;
+    LosVmPage *page = NULL;
+    UINT32 intSave;
+
+    if (!OsVmZeroPoolRoomCheck()) {
+        return;
+    }
+
+    while (pool->count < pool->target) {
+        page = LOS_PhysPageAlloc();
+        if (page == NULL) {
+            return;
+        }
+        (VOID)memset_s(OsVmPageToVaddr(page), PAGE_SIZE, 0, PAGE_SIZE);
+
+        LOS_SpinLockSave(&pool->lock, &intSave);
+        if (pool->count >= pool->target) {
+            LOS_SpinUnlockRestore(&pool->lock, intSave);
+            LOS_PhysPageFree(page);
+            return;
+        }
+        LOS_ListTailInsert(&pool->list, &page->node);
+        pool->count++;
+        pool->zeroed++;
+        LOS_SpinUnlockRestore(&pool->lock, intSave);
+    }
+}
+
+STATIC VOID OsVmZeroPoolTask(VOID)
+{
+    while (1) {
+        (VOID)LOS_EventRead(&g_vmZeroPoolEvent, OS_ZERO_POOL_EVENT_REFILL,
+                            LOS_WAITMODE_OR | LOS_WAITMODE_CLR, LOS_WAIT_FOREVER);
+        OsVmZeroPoolRefill();
+    }
+}
+
+LosVmPage *OsVmZeroPoolGet(VOID)
+{
+    VmZeroPool *pool = &g_vmZeroPool;
+    LosVmPage *page = NULL;
+    BOOL wakeup = FALSE;
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&pool->lock, &intSave);
+    if (pool->count != 0) {
+        page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&pool->list), LosVmPage, node);
+        LOS_ListDelete(&page->node);
+        pool->count--;
+        pool->hits++;
+    } else {
+        pool->misses++;
+    }
+    wakeup = (pool->count < (pool->target >> 1));
+    LOS_SpinUnlockRestore(&pool->lock, intSave);
+
+    if (wakeup) {
+        OsVmZeroPoolWakeup();
+    }
+    return page;
+}
+
+UINT32 OsVmZeroPoolShrink(VOID)
+{
+    VmZeroPool *pool = &g_vmZeroPool;
+    LOS_DL_LIST list;
+    LosVmPage *page = NULL;
+    LosVmPage *next = NULL;
+    UINT32 count;
+    UINT32 intSave;
+
+    LOS_ListInit(&list);
+    LOS_SpinLockSave(&pool->lock, &intSave);
+    count = pool->count;
+    if (count != 0) {
+        /* Move the whole pool over to the local list */
+        list.pstNext = pool->list.pstNext;
+        list.pstPrev = pool->list.pstPrev;
+        list.pstNext->pstPrev = &list;
+        list.pstPrev->pstNext = &list;
+        LOS_ListInit(&pool->list);
+        pool->count = 0;
+        pool->reclaimed += count;
+    }
+    LOS_SpinUnlockRestore(&pool->lock, intSave);
+
+    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(page, next, &list, LosVmPage, node) {
+        LOS_ListDelete(&page->node);
+        LOS_PhysPageFree(page);
+    }
+    return count;
+}
+
+UINT32 OsVmZeroPoolTargetSet(UINT32 pages)
+{
+    VmZeroPool *pool = &g_vmZeroPool;
+    UINT32 intSave;
+
+    if (pages > OS_ZERO_POOL_MAX_PAGES) {
+        return LOS_NOK;
+    }
+
+    LOS_SpinLockSave(&pool->lock, &intSave);
+    pool->target = pages;
+    LOS_SpinUnlockRestore(&pool->lock, intSave);
+
+    /* A smaller pool gives its surplus back at once, the task fills it up again */
+    if (pool->count > pages) {
+        (VOID)OsVmZeroPoolShrink();
+    }
+    OsVmZeroPoolWakeup();
+    return LOS_OK;
+}
+
+VOID OsVmZeroPoolShow(struct SeqBuf *seqBuf)
+{
+    VmZeroPool *pool = &g_vmZeroPool;
+    VmZeroPool snap;
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&pool->lock, &intSave);
+    snap = *pool;
+    LOS_SpinUnlockRestore(&pool->lock, intSave);
+
+    (VOID)LosBufPrintf(seqBuf, "target     %u\n", snap.target);
+    (VOID)LosBufPrintf(seqBuf, "pooled     %u\n", snap.count);
+    (VOID)LosBufPrintf(seqBuf, "hits       %u\n", snap.hits);
+    (VOID)LosBufPrintf(seqBuf, "misses     %u\n", snap.misses);
+    (VOID)LosBufPrintf(seqBuf, "zeroed     %u\n", snap.zeroed);
+    (VOID)LosBufPrintf(seqBuf, "reclaimed  %u\n", snap.reclaimed);
+}
+
+STATIC UINT32 OsVmZeroPoolInit(VOID)
+{
+    UINT32 ret;
+    UINT32 taskID;
+    TSK_INIT_PARAM_S taskInitParam;
+
+    ret = LOS_EventInit(&g_vmZeroPoolEvent);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    (VOID)memset_s((VOID *)(&taskInitParam), sizeof(TSK_INIT_PARAM_S), 0, sizeof(TSK_INIT_PARAM_S));
+    taskInitParam.pfnTaskEntry = (TSK_ENTRY_FUNC)OsVmZeroPoolTask;
+    taskInitParam.uwStackSize = OS_ZERO_POOL_STACK_SIZE;
+    taskInitParam.pcName = "ZeroPageTask";
+    taskInitParam.usTaskPrio = OS_TASK_PRIORITY_LOWEST;
+    ret = LOS_TaskCreate(&taskID, &taskInitParam);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+    OS_TCB_FROM_TID(taskID)->taskStatus |= OS_TASK_FLAG_NO_DELETE;
+
+    g_vmZeroPoolReady = TRUE;
+    OsVmZeroPoolWakeup();
+    return LOS_OK;
+}
+
+LOS_MODULE_INIT(OsVmZeroPoolInit, LOS_INIT_LEVEL_KMOD_TASK);
+#endif
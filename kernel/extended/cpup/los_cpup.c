@@ -242,7 +242,8 @@ VOID OsCpupCycleEndStart(UINT32 runTaskID, UINT32 newTaskID)
     LosTaskCB *runTask = OS_TCB_FROM_TID(runTaskID);
     OsCpupBase *runTaskCpup = &runTask->taskCpup;
     OsCpupBase *newTaskCpup = (OsCpupBase *)&(OS_TCB_FROM_TID(newTaskID)->taskCpup);
-    OsCpupBase *processCpup = (OsCpupBase *)&(OS_PCB_FROM_PID(runTask->processID)->processCpup);
+    LosProcessCB *runProcess = OS_PCB_FROM_PID(runTask->processID);
+    OsCpupBase *processCpup = &runProcess->processCpup;
     UINT64 cpuCycle, cycleIncrement;
     UINT16 cpuID = ArchCurrCpuid();
 
@@ -259,6 +260,9 @@ VOID OsCpupCycleEndStart(UINT32 runTaskID, UINT32 newTaskID)
 #endif
         runTaskCpup->allTime += cycleIncrement;
         processCpup->allTime += cycleIncrement;
+        if (runProcess->group != NULL) {
+            runProcess->group->cpupTime += cycleIncrement;
+        }
         runTaskCpup->startTime = 0;
     }
 
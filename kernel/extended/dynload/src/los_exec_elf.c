@@ -155,6 +155,11 @@ INT32 LOS_DoExecveFile(const CHAR *fileName, CHAR * const *argv, CHAR * const *e
         return ret;
     }
 
+    /* a vfork child hands the old space back to its parent instead of freeing it */
+    if (OsProcessVforkRelease(OsCurrProcessGet())) {
+        loadInfo.oldSpace = NULL;
+    }
+
     ret = OsExecRecycleAndInit(OsCurrProcessGet(), loadInfo.fileName, loadInfo.oldSpace, loadInfo.oldFiles);
     if (ret != LOS_OK) {
         (VOID)LOS_VmSpaceFree(loadInfo.oldSpace);
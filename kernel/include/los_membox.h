@@ -38,6 +38,7 @@
 #define _LOS_MEMBOX_H
 
 #include "los_config.h"
+#include "los_atomic.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -65,7 +66,7 @@ typedef struct {
     UINT32 uwBlkSize;           /**< Block size */
     UINT32 uwBlkNum;            /**< Block number */
     UINT32 uwBlkCnt;            /**< The number of allocated blocks */
-    LOS_MEMBOX_NODE stFreeList; /**< Free list */
+    Atomic uwFreeHead;          /**< Free list head, index of the first free block + 1 tagged against ABA */
 } LOS_MEMBOX_INFO;
 
 typedef LOS_MEMBOX_INFO OS_MEMBOX_S;
@@ -1048,6 +1048,58 @@ extern INT32 LOS_GetTaskScheduler(INT32 taskID);
  */
 extern INT32 LOS_SetTaskScheduler(INT32 taskID, UINT16 policy, UINT16 priority);
 
+/**
+ * @ingroup  los_task
+ * @brief Set the deadline scheduling parameters for the task.
+ *
+ * @par Description:
+ * This API is used to make the task a deadline task that gets runtime nanoseconds of cpu time
+ * in every period, finished within deadline nanoseconds of the start of the period.
+ *
+ * @attention
+ * <ul>
+ * <li>runtime <= deadline <= period must be met, a deadline of 0 means the deadline equals the period.</li>
+ * <li>The parameters are rejected if the bandwidth of all deadline tasks would exceed the cpu capacity.</li>
+ * </ul>
+ *
+ * @param  taskID       [IN]  Type  #UINT32 Task ID. The task id value is obtained from task creation.
+ * @param  runtime      [IN]  Type  #UINT64 Runtime budget of each period, in nanoseconds.
+ * @param  deadline     [IN]  Type  #UINT64 Relative deadline, in nanoseconds.
+ * @param  period       [IN]  Type  #UINT64 Replenishment period, in nanoseconds.
+ *
+ * @retval #LOS_ESRCH       Invalid task id.
+ * @retval #LOS_EINVAL      Invalid parameters.
+ * @retval #LOS_EBUSY       The bandwidth can not be reserved.
+ * @retval #0               Set up the success.
+ * @par Dependency:
+ * <ul><li>los_task.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_GetTaskDeadline
+ */
+extern INT32 LOS_SetTaskDeadline(INT32 taskID, UINT64 runtime, UINT64 deadline, UINT64 period);
+
+/**
+ * @ingroup  los_task
+ * @brief Get the deadline scheduling parameters for the task.
+ *
+ * @par Description:
+ * This API is used to get the runtime, deadline and period of the task, in nanoseconds.
+ *
+ * @attention None.
+ *
+ * @param  taskID       [IN]  Type  #UINT32 Task ID. The task id value is obtained from task creation.
+ * @param  runtime      [OUT] Type  #UINT64 * Runtime budget of each period.
+ * @param  deadline     [OUT] Type  #UINT64 * Relative deadline.
+ * @param  period       [OUT] Type  #UINT64 * Replenishment period.
+ *
+ * @retval #LOS_ESRCH       Invalid task id.
+ * @retval #LOS_EINVAL      Invalid parameters.
+ * @retval #0               Get the success.
+ * @par Dependency:
+ * <ul><li>los_task.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_SetTaskDeadline
+ */
+extern INT32 LOS_GetTaskDeadline(INT32 taskID, UINT64 *runtime, UINT64 *deadline, UINT64 *period);
+
 /**
  * @ingroup  los_task
  * @brief Trigger active task scheduling.
@@ -51,6 +51,7 @@
 #include "user_copy.h"
 #include "los_vm_map.h"
 #include "los_memory.h"
+#include "los_arena_pri.h"
 #include "los_strncpy_from_user.h"
 #include "capability_type.h"
 #include "capability_api.h"
@@ -153,19 +154,19 @@ static int UserIovCopy(struct iovec **iovBuf, const struct iovec *iov, const int
         return -EINVAL;
     }
 
-    *iovBuf = (struct iovec*)LOS_MemAlloc(OS_SYS_MEM_ADDR, bufLen);
+    *iovBuf = (struct iovec*)OsSyscallArenaAlloc(bufLen);
     if (*iovBuf == NULL) {
         return -ENOMEM;
     }
 
     if (LOS_ArchCopyFromUser(*iovBuf, iov, bufLen) != 0) {
-        (void)LOS_MemFree(OS_SYS_MEM_ADDR, *iovBuf);
+        OsSyscallArenaFree(*iovBuf);
         return -EFAULT;
     }
 
     ret = UserIovItemCheck(*iovBuf, iovcnt);
     if (ret == 0) {
-        (void)LOS_MemFree(OS_SYS_MEM_ADDR, *iovBuf);
+        OsSyscallArenaFree(*iovBuf);
         return -EFAULT;
     }
 
@@ -182,7 +183,7 @@ static int PollfdToSystem(struct pollfd *fds, nfds_t nfds, int **pollFdsBak)
     if (nfds == 0) {
         return 0;
     }
-    int *pollFds = (int *)malloc(sizeof(int) * nfds);
+    int *pollFds = (int *)OsSyscallArenaAlloc(sizeof(int) * nfds);
     if (pollFds == NULL) {
         set_errno(ENOMEM);
         return -1;
@@ -192,7 +193,7 @@ static int PollfdToSystem(struct pollfd *fds, nfds_t nfds, int **pollFdsBak)
         pollFds[i] = p_fds->fd;
         if (p_fds->fd < 0) {
             set_errno(EBADF);
-            free(pollFds);
+            OsSyscallArenaFree(pollFds);
             return -1;
         }
         p_fds->fd = GetAssociatedSystemFd(p_fds->fd);
@@ -224,7 +225,7 @@ static int UserPoll(struct pollfd *fds, nfds_t nfds, int timeout)
 
     RestorePollfd(fds, nfds, pollFds);
 
-    free(pollFds);
+    OsSyscallArenaFree(pollFds);
     return ret;
 }
 
@@ -1374,7 +1375,7 @@ ssize_t SysReadv(int fd, const struct iovec *iov, int iovcnt)
     }
 
 OUT:
-    (void)LOS_MemFree(OS_SYS_MEM_ADDR, iovRet);
+    OsSyscallArenaFree(iovRet);
     return ret;
 }
 
@@ -1414,7 +1415,7 @@ ssize_t SysWritev(int fd, const struct iovec *iov, int iovcnt)
     }
 
 OUT_FREE:
-    (void)LOS_MemFree(OS_SYS_MEM_ADDR, iovRet);
+    OsSyscallArenaFree(iovRet);
     return ret;
 }
 
@@ -1427,7 +1428,7 @@ int SysPoll(struct pollfd *fds, nfds_t nfds, int timeout)
         return -EINVAL;
     }
 
-    kfds = (struct pollfd *)malloc(sizeof(struct pollfd) * nfds);
+    kfds = (struct pollfd *)OsSyscallArenaAlloc(sizeof(struct pollfd) * nfds);
     if (kfds != NULL) {
         if (LOS_ArchCopyFromUser(kfds, fds, sizeof(struct pollfd) * nfds) != 0) {
             ret = -EFAULT;
@@ -1457,9 +1458,9 @@ int SysPoll(struct pollfd *fds, nfds_t nfds, int timeout)
     }
 
 OUT:
-    free(pollFds);
+    OsSyscallArenaFree(pollFds);
 OUT_KFD:
-    free(kfds);
+    OsSyscallArenaFree(kfds);
     return ret;
 }
 
@@ -1583,7 +1584,7 @@ char *SysGetcwd(char *buf, size_t n)
         bufLen = PATH_MAX;
     }
 
-    bufRet = (char *)LOS_MemAlloc(OS_SYS_MEM_ADDR, bufLen);
+    bufRet = (char *)OsSyscallArenaAlloc(bufLen);
     if (bufRet == NULL) {
         return (char *)(intptr_t)-ENOMEM;
     }
@@ -1591,18 +1592,18 @@ char *SysGetcwd(char *buf, size_t n)
 
     ret = getcwd((buf ? bufRet : NULL), bufLen);
     if (ret == NULL) {
-        (void)LOS_MemFree(OS_SYS_MEM_ADDR, bufRet);
+        OsSyscallArenaFree(bufRet);
         return (char *)(intptr_t)-get_errno();
     }
 
     retVal = LOS_ArchCopyToUser(buf, bufRet, bufLen);
     if (retVal != 0) {
-        (void)LOS_MemFree(OS_SYS_MEM_ADDR, bufRet);
+        OsSyscallArenaFree(bufRet);
         return (char *)(intptr_t)-EFAULT;
     }
     ret = buf;
 
-    (void)LOS_MemFree(OS_SYS_MEM_ADDR, bufRet);
+    OsSyscallArenaFree(bufRet);
     return ret;
 }
 
@@ -1996,7 +1997,7 @@ ssize_t SysPreadv(int fd, const struct iovec *iov, int iovcnt, long loffset, lon
     }
 
 OUT_FREE:
-    (void)(void)LOS_MemFree(OS_SYS_MEM_ADDR, iovRet);
+    OsSyscallArenaFree(iovRet);
     return ret;
 }
 
@@ -2034,7 +2035,7 @@ ssize_t SysPwritev(int fd, const struct iovec *iov, int iovcnt, long loffset, lo
     }
 
 OUT_FREE:
-    (void)LOS_MemFree(OS_SYS_MEM_ADDR, iovRet);
+    OsSyscallArenaFree(iovRet);
     return ret;
 }
 
@@ -37,6 +37,7 @@
 #include "los_signal.h"
 #include "los_syscall.h"
 #include "los_task_pri.h"
+#include "los_arena_pri.h"
 #include "los_process_pri.h"
 #include "los_hw_pri.h"
 #include "los_printf.h"
@@ -102,6 +103,9 @@ VOID OsArmA32SyscallHandle(TaskContext *regs)
     UINT8 nArgs;
     UINTPTR handle;
     UINT32 cmd = regs->reserved2;
+#ifdef LOSCFG_KERNEL_SYSCALL_ARENA
+    UINT64 arenaFast[OS_SYSCALL_ARENA_FAST_SIZE / sizeof(UINT64)];
+#endif
 
     if (cmd >= SYS_CALL_NUM) {
         PRINT_ERR("Syscall ID: error %d !!!\n", cmd);
@@ -117,6 +121,9 @@ VOID OsArmA32SyscallHandle(TaskContext *regs)
         return;
     }
 
+#ifdef LOSCFG_KERNEL_SYSCALL_ARENA
+    OsSyscallArenaEnter((UINT8 *)arenaFast);
+#endif
     OsSigIntLock();
     switch (nArgs) {
         case ARG_NUM_0:
@@ -137,6 +144,9 @@ VOID OsArmA32SyscallHandle(TaskContext *regs)
 
     regs->R0 = ret;
     OsSigIntUnlock();
+#ifdef LOSCFG_KERNEL_SYSCALL_ARENA
+    OsSyscallArenaExit();
+#endif
 
     return;
 }
@@ -67,12 +67,26 @@
 #include "vnode.h"
 #endif
 
+/* Layout of the linux sched_attr, used by sched_setattr and sched_getattr */
+struct sched_attr {
+    unsigned int size;
+    unsigned int sched_policy;
+    unsigned long long sched_flags;
+    int sched_nice;
+    unsigned int sched_priority;
+    unsigned long long sched_runtime;  /* nanoseconds */
+    unsigned long long sched_deadline; /* nanoseconds */
+    unsigned long long sched_period;   /* nanoseconds */
+};
+
 /* process */
 extern unsigned int SysGetGroupId(void);
 extern unsigned int SysGetTid(void);
 extern void SysSchedYield(int type);
 extern int SysSchedGetScheduler(int id, int flag);
 extern int SysSchedSetScheduler(int id, int policy, int prio, int flag);
+extern int SysSchedSetAttr(int id, struct sched_attr *userAttr, unsigned int flags);
+extern int SysSchedGetAttr(int id, struct sched_attr *userAttr, unsigned int size, unsigned int flags);
 extern int SysSchedGetParam(int id, int flag);
 extern int SysSchedSetParam(int id, unsigned int prio, int flag);
 extern int SysSetProcessPriority(int which, int who, unsigned int prio);
@@ -64,7 +64,7 @@ static int OsUserTaskSchedulerSet(unsigned int tid, unsigned short policy, unsig
 {
     int ret;
     unsigned int intSave;
-    bool needSched = false;
+    BOOL needSched = FALSE;
 
     if (OS_TID_CHECK_INVALID(tid)) {
         return EINVAL;
@@ -74,7 +74,7 @@ static int OsUserTaskSchedulerSet(unsigned int tid, unsigned short policy, unsig
         return EINVAL;
     }
 
-    if ((policy != LOS_SCHED_FIFO) && (policy != LOS_SCHED_RR)) {
+    if ((policy != LOS_SCHED_FIFO) && (policy != LOS_SCHED_RR) && (policy != LOS_SCHED_DEADLINE)) {
         return EINVAL;
     }
 
@@ -87,8 +87,20 @@ static int OsUserTaskSchedulerSet(unsigned int tid, unsigned short policy, unsig
     }
 
     policy = (policyFlag == true) ? policy : taskCB->policy;
-    needSched = OsSchedModifyTaskSchedParam(taskCB, policy, priority);
+    if ((policy == LOS_SCHED_DEADLINE) && (taskCB->policy != LOS_SCHED_DEADLINE)) {
+        /* Uses the deadline parameters last set by sched_setattr */
+        UINT64 runtime = 0;
+        UINT64 deadline = 0;
+        UINT64 period = 0;
+        OsSchedGetTaskDeadlineParam(taskCB, &runtime, &deadline, &period);
+        ret = OsSchedModifyTaskDeadlineParam(taskCB, runtime, deadline, period, &needSched);
+    } else {
+        needSched = OsSchedModifyTaskSchedParam(taskCB, policy, priority);
+    }
     SCHEDULER_UNLOCK(intSave);
+    if (ret != LOS_OK) {
+        return ret;
+    }
 
     LOS_MpSchedule(OS_MP_CPU_ALL);
     if (needSched && OS_SCHEDULER_ACTIVE) {
@@ -156,6 +168,105 @@ int SysSchedSetScheduler(int id, int policy, int prio, int flag)
     return OsSetProcessScheduler(LOS_PRIO_PROCESS, id, prio, policy);
 }
 
+int SysSchedSetAttr(int id, struct sched_attr *userAttr, unsigned int flags)
+{
+    int ret;
+    unsigned int intSave;
+    BOOL needSched = FALSE;
+    struct sched_attr attr;
+    unsigned int size;
+
+    if ((userAttr == NULL) || (flags != 0)) {
+        return -EINVAL;
+    }
+
+    ret = LOS_ArchCopyFromUser(&size, &userAttr->size, sizeof(size));
+    if (ret != 0) {
+        return -EFAULT;
+    }
+
+    /* the layout is only known for callers built against the same struct */
+    if (size != sizeof(struct sched_attr)) {
+        return -E2BIG;
+    }
+
+    ret = LOS_ArchCopyFromUser(&attr, userAttr, sizeof(struct sched_attr));
+    if (ret != 0) {
+        return -EFAULT;
+    }
+
+    if (id == 0) {
+        id = (int)OsCurrTaskGet()->taskID;
+    }
+
+    if (attr.sched_policy != LOS_SCHED_DEADLINE) {
+        return -OsUserTaskSchedulerSet(id, attr.sched_policy, attr.sched_priority, true);
+    }
+
+    if (OS_TID_CHECK_INVALID(id)) {
+        return -EINVAL;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    LosTaskCB *taskCB = OS_TCB_FROM_TID(id);
+    ret = OsUserTaskOperatePermissionsCheck(taskCB);
+    if (ret == LOS_OK) {
+        ret = OsSchedModifyTaskDeadlineParam(taskCB, attr.sched_runtime, attr.sched_deadline, attr.sched_period,
+                                             &needSched);
+    }
+    SCHEDULER_UNLOCK(intSave);
+    if (ret != LOS_OK) {
+        return -ret;
+    }
+
+    LOS_MpSchedule(OS_MP_CPU_ALL);
+    if (needSched && OS_SCHEDULER_ACTIVE) {
+        LOS_Schedule();
+    }
+
+    return LOS_OK;
+}
+
+int SysSchedGetAttr(int id, struct sched_attr *userAttr, unsigned int size, unsigned int flags)
+{
+    int ret;
+    unsigned int intSave;
+    struct sched_attr attr = { 0 };
+
+    if ((userAttr == NULL) || (size < sizeof(struct sched_attr)) || (flags != 0)) {
+        return -EINVAL;
+    }
+
+    if (id == 0) {
+        id = (int)OsCurrTaskGet()->taskID;
+    }
+
+    if (OS_TID_CHECK_INVALID(id)) {
+        return -EINVAL;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    LosTaskCB *taskCB = OS_TCB_FROM_TID(id);
+    ret = OsUserTaskOperatePermissionsCheck(taskCB);
+    if (ret != LOS_OK) {
+        SCHEDULER_UNLOCK(intSave);
+        return -ret;
+    }
+
+    attr.size = sizeof(struct sched_attr);
+    attr.sched_policy = taskCB->policy;
+    attr.sched_priority = taskCB->priority;
+    OsSchedGetTaskDeadlineParam(taskCB, &attr.sched_runtime, &attr.sched_deadline, &attr.sched_period);
+    SCHEDULER_UNLOCK(intSave);
+
+    ret = LOS_ArchCopyToUser(userAttr, &attr, sizeof(struct sched_attr));
+    if (ret != 0) {
+        return -EFAULT;
+    }
+
+    return LOS_OK;
+}
+
 int SysSchedGetParam(int id, int flag)
 {
     LosTaskCB *taskCB = NULL;
@@ -346,7 +457,7 @@ int SysFork(void)
 
 int SysVfork(void)
 {
-    return OsClone(CLONE_VFORK, 0, 0);
+    return OsClone(CLONE_VFORK | CLONE_VM, 0, 0);
 }
 
 unsigned int SysGetPPID(void)
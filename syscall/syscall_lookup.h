@@ -166,6 +166,8 @@ SYSCALL_HAND_DEF(__NR_sched_get_priority_min, SysSchedGetPriorityMin, int, ARG_N
 SYSCALL_HAND_DEF(__NR_sched_setaffinity, SysSchedSetAffinity, int, ARG_NUM_3)
 SYSCALL_HAND_DEF(__NR_sched_getaffinity, SysSchedGetAffinity, int, ARG_NUM_3)
 SYSCALL_HAND_DEF(__NR_sched_rr_get_interval, SysSchedRRGetInterval, int, ARG_NUM_2)
+SYSCALL_HAND_DEF(__NR_sched_setattr, SysSchedSetAttr, int, ARG_NUM_3)
+SYSCALL_HAND_DEF(__NR_sched_getattr, SysSchedGetAttr, int, ARG_NUM_4)
 SYSCALL_HAND_DEF(__NR_nanosleep, SysNanoSleep, int, ARG_NUM_2)
 SYSCALL_HAND_DEF(__NR_mremap, SysMremap, void *, ARG_NUM_5)
 SYSCALL_HAND_DEF(__NR_umask, SysUmask, mode_t, ARG_NUM_1)
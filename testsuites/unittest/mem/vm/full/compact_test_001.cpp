@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_vm.h"
+
+#define PAGE_LEN 0x1000
+#define FILE_PAGES 64
+#define FRAG_PAGES 256
+#define COMPACT_ORDER "4"
+#define COMPACT_LOOP 4
+
+static char g_compactFile[] = "/storage/testCompact.txt";
+
+static int CheckPattern(const unsigned char *buf, int page)
+{
+    for (int i = 0; i < PAGE_LEN; i++) {
+        if (buf[i] != (unsigned char)(page + i)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Page cache pages inside a fragmented block are moved by compaction and keep their contents */
+static int Testcase(void)
+{
+    unsigned char buf[PAGE_LEN];
+    unsigned char *file = NULL;
+    char *frag = NULL;
+    int ret, fd, procFd;
+
+    /* Not every configuration builds compaction in */
+    if (access("/proc/compaction", F_OK) != 0) {
+        return 0;
+    }
+
+    fd = open(g_compactFile, O_CREAT | O_RDWR, S_IRWXU | S_IRWXG | S_IRWXO);
+    ICUNIT_ASSERT_NOT_EQUAL(fd, -1, fd);
+
+    for (int page = 0; page < FILE_PAGES; page++) {
+        for (int i = 0; i < PAGE_LEN; i++) {
+            buf[i] = (unsigned char)(page + i);
+        }
+        ret = write(fd, buf, PAGE_LEN);
+        ICUNIT_GOTO_EQUAL(ret, PAGE_LEN, ret, EXIT);
+    }
+
+    file = (unsigned char *)mmap(NULL, FILE_PAGES * PAGE_LEN, PROT_READ, MAP_SHARED, fd, 0);
+    ICUNIT_GOTO_NOT_EQUAL(file, MAP_FAILED, file, EXIT);
+
+    /* Interleave the page cache with anonymous pages, then free every other one */
+    frag = (char *)mmap(NULL, FRAG_PAGES * PAGE_LEN, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+    ICUNIT_GOTO_NOT_EQUAL(frag, MAP_FAILED, frag, EXIT1);
+    for (int page = 0; page < FRAG_PAGES; page++) {
+        frag[page * PAGE_LEN] = 1;
+        if (page < FILE_PAGES) {
+            ret = CheckPattern(file + page * PAGE_LEN, page);
+            ICUNIT_GOTO_EQUAL(ret, 0, page, EXIT2);
+        }
+    }
+    for (int page = 0; page < FRAG_PAGES; page += 2) { /* 2: free every other page */
+        ret = munmap(frag + page * PAGE_LEN, PAGE_LEN);
+        ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT2);
+    }
+
+    procFd = open("/proc/compaction", O_WRONLY);
+    ICUNIT_GOTO_NOT_EQUAL(procFd, -1, procFd, EXIT2);
+    for (int loop = 0; loop < COMPACT_LOOP; loop++) {
+        ret = write(procFd, COMPACT_ORDER, sizeof(COMPACT_ORDER));
+        ICUNIT_GOTO_EQUAL(ret, sizeof(COMPACT_ORDER), ret, EXIT3);
+    }
+
+    /* Both the mapping, faulted in again, and the cache behind read see the original data */
+    for (int page = 0; page < FILE_PAGES; page++) {
+        ret = CheckPattern(file + page * PAGE_LEN, page);
+        ICUNIT_GOTO_EQUAL(ret, 0, page, EXIT3);
+        ret = pread(fd, buf, PAGE_LEN, page * PAGE_LEN);
+        ICUNIT_GOTO_EQUAL(ret, PAGE_LEN, ret, EXIT3);
+        ret = CheckPattern(buf, page);
+        ICUNIT_GOTO_EQUAL(ret, 0, page, EXIT3);
+    }
+
+EXIT3:
+    (void)close(procFd);
+EXIT2:
+    for (int page = 1; page < FRAG_PAGES; page += 2) { /* 2: the odd pages are still mapped */
+        (void)munmap(frag + page * PAGE_LEN, PAGE_LEN);
+    }
+EXIT1:
+    (void)munmap(file, FILE_PAGES * PAGE_LEN);
+EXIT:
+    (void)close(fd);
+    (void)remove(g_compactFile);
+    return 0;
+}
+
+void ItTestCompact001(void)
+{
+    TEST_ADD_CASE("IT_MEM_COMPACT_001", Testcase, TEST_LOS, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
@@ -58,4 +58,5 @@ extern void ItTestMremap001(void);
 extern void ItTestOom001(void);
 extern void ItTestUserCopy001(void);
 extern void open_wmemstream_test_001(void);
+extern void ItTestCompact001(void);
 #endif
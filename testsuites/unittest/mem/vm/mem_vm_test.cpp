@@ -210,4 +210,17 @@ HWTEST_F(MemVmTest, open_wmemstream_test_001, TestSize.Level0)
     open_wmemstream_test_001();
 }
 #endif
+
+#if defined(LOSCFG_USER_TEST_FULL)
+/* *
+ * @tc.name: it_test_compact_001
+ * @tc.desc: function for MemVmTest
+ * @tc.type: FUNC
+ * @tc.require: AR000EEMQ9
+ */
+HWTEST_F(MemVmTest, ItTestCompact001, TestSize.Level0)
+{
+    ItTestCompact001();
+}
+#endif
 } // namespace OHOS
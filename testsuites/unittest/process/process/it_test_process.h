@@ -122,6 +122,7 @@ extern void ItTestProcess066(void);
 extern void ItTestProcess067(void);
 extern void ItTestProcess068(void);
 extern void ItTestProcess069(void);
+extern void ItTestProcess070(void);
 extern void ItTestProcessSmp001(void);
 extern void ItTestProcessSmp002(void);
 extern void ItTestProcessSmp003(void);
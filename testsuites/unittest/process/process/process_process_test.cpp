@@ -746,6 +746,17 @@ HWTEST_F(ProcessProcessTest, ItTestProcess069, TestSize.Level0)
     ItTestProcess069();
 }
 
+/* *
+ * @tc.name: it_test_process_070
+ * @tc.desc: function for vfork: the child exits or execs and the parent resumes, with one or more parent threads.
+ * @tc.type: FUNC
+ * @tc.require: AR000E0QAB
+ */
+HWTEST_F(ProcessProcessTest, ItTestProcess070, TestSize.Level0)
+{
+    ItTestProcess070();
+}
+
 #ifdef LOSCFG_USER_TEST_SMP
 /* *
  * @tc.name: it_test_process_smp_001
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_process.h"
+#include <pthread.h>
+
+static const int VFORK_EXIT_CODE = 12;
+static const int EXEC_FAIL_CODE = 13;
+static const int HELPER_FAIL_CODE = 14;
+static const int SPACE_MARK = 0x5a;
+
+static volatile int g_vforkMark = 0;
+static volatile int g_threadStop = 0;
+
+static int VforkExit(int shared)
+{
+    int local = SPACE_MARK;
+    int status = 0;
+    pid_t pid;
+
+    g_vforkMark = 0;
+    pid = vfork();
+    if (pid == 0) {
+        g_vforkMark = SPACE_MARK;
+        _exit(VFORK_EXIT_CODE);
+    }
+    if ((pid < 0) || (local != SPACE_MARK)) {
+        return -1;
+    }
+    /* the child only writes into the parent when it borrowed the space */
+    if (shared && (g_vforkMark != SPACE_MARK)) {
+        return -1;
+    }
+
+    if ((waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) || (WEXITSTATUS(status) != VFORK_EXIT_CODE)) {
+        return -1;
+    }
+    return 0;
+}
+
+static int VforkExec(void)
+{
+    char *argv[] = {"tftp", NULL};
+    int local = SPACE_MARK;
+    int status = 0;
+    pid_t pid;
+
+    pid = vfork();
+    if (pid == 0) {
+        execve("/bin/tftp", argv, NULL);
+        _exit(EXEC_FAIL_CODE);
+    }
+    if ((pid < 0) || (local != SPACE_MARK)) {
+        return -1;
+    }
+
+    if ((waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) || (WEXITSTATUS(status) == EXEC_FAIL_CODE)) {
+        return -1;
+    }
+    return 0;
+}
+
+static void *ThreadSpin(void *arg)
+{
+    (void)arg;
+    while (!g_threadStop) {
+        usleep(1000); /* 1000, wake up every millisecond */
+    }
+    return NULL;
+}
+
+/* A parent with more threads can not lend its space, vfork then copies it and must still work */
+static int VforkMultiThread(void)
+{
+    pthread_t thread;
+    int ret;
+
+    g_threadStop = 0;
+    if (pthread_create(&thread, NULL, ThreadSpin, NULL) != 0) {
+        return -1;
+    }
+
+    ret = VforkExit(0);
+    if (ret == 0) {
+        ret = VforkExec();
+    }
+
+    g_threadStop = 1;
+    (void)pthread_join(thread, NULL);
+    return ret;
+}
+
+static int RunInHelper(int multiThread)
+{
+    int status = 0;
+    pid_t pid;
+    int ret;
+
+    /* the test runner may have threads of its own, a fresh child is known to have one */
+    pid = fork();
+    if (pid == 0) {
+        if (multiThread) {
+            ret = VforkMultiThread();
+        } else {
+            ret = VforkExit(1);
+            if (ret == 0) {
+                ret = VforkExec();
+            }
+        }
+        exit((ret == 0) ? 0 : HELPER_FAIL_CODE);
+    }
+    if (pid < 0) {
+        return -1;
+    }
+
+    ret = waitpid(pid, &status, 0);
+    if ((ret != pid) || !WIFEXITED(status)) {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+static int TestCase(void)
+{
+    int ret;
+
+    ret = RunInHelper(0);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+
+    ret = RunInHelper(1);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+
+    return 0;
+}
+
+void ItTestProcess070(void)
+{
+    TEST_ADD_CASE("IT_POSIX_PROCESS_070", TestCase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}